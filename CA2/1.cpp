@@ -1,96 +1,479 @@
-#include <SFML/Graphics.hpp>
-#include <omp.h>
-#include <iostream>
-#include <ctime>
-
-#define WIDTH 800
-#define HEIGHT 800
-#define MAX_ITER 1000
-
-void compute_mandelbrot_serial(double real_min, double real_max, double imag_min, double imag_max, int width, int height, int max_iter, int *output) {
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            double real = real_min + (real_max - real_min) * x / width;
-            double imag = imag_min + (imag_max - imag_min) * y / height;
-            double zr = real, zi = imag;
-            int iter;
-            for (iter = 0; iter < max_iter; iter++) {
-                double zr2 = zr * zr, zi2 = zi * zi;
-                if (zr2 + zi2 > 4.0) break;
-                zi = 2.0 * zr * zi + imag;
-                zr = zr2 - zi2 + real;
-            }
-            output[y * width + x] = iter;
-        }
-    }
-}
-
-void compute_mandelbrot_parallel(double real_min, double real_max, double imag_min, double imag_max, int width, int height, int max_iter, int *output) {
-    #pragma omp parallel for schedule(dynamic)
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            double real = real_min + (real_max - real_min) * x / width;
-            double imag = imag_min + (imag_max - imag_min) * y / height;
-            double zr = real, zi = imag;
-            int iter;
-            for (iter = 0; iter < max_iter; iter++) {
-                double zr2 = zr * zr, zi2 = zi * zi;
-                if (zr2 + zi2 > 4.0) break;
-                zi = 2.0 * zr * zi + imag;
-                zr = zr2 - zi2 + real;
-            }
-            output[y * width + x] = iter;
-        }
-    }
-}
-
-int main() {
-    int *output_serial = (int *)malloc(WIDTH * HEIGHT * sizeof(int));
-    int *output_parallel = (int *)malloc(WIDTH * HEIGHT * sizeof(int));
-
-    clock_t start_serial, end_serial;
-    double time_serial;
-    start_serial = clock();
-    compute_mandelbrot_serial(-2.0, 1.0, -1.5, 1.5, WIDTH, HEIGHT, MAX_ITER, output_serial);
-    end_serial = clock();
-    time_serial = ((double) (end_serial - start_serial)) / CLOCKS_PER_SEC;
-
-    double start_parallel, end_parallel;
-    double time_parallel;
-    start_parallel = omp_get_wtime();
-    compute_mandelbrot_parallel(-2.0, 1.0, -1.5, 1.5, WIDTH, HEIGHT, MAX_ITER, output_parallel);
-    end_parallel = omp_get_wtime();
-    time_parallel = end_parallel - start_parallel;
-
-    double speedup = time_serial / time_parallel;
-    std::cout << "Serial Time: " << time_serial << " seconds\n";
-    std::cout << "Parallel Time: " << time_parallel << " seconds\n";
-    std::cout << "Speedup: " << speedup << "\n";
-
-    sf::RenderWindow window(sf::VideoMode(WIDTH, HEIGHT), "Mandelbrot Set");
-    sf::Image image;
-    image.create(WIDTH, HEIGHT);
-    for (int y = 0; y < HEIGHT; y++) {
-        for (int x = 0; x < WIDTH; x++) {
-            int iter = output_parallel[y * WIDTH + x];
-            sf::Color color = (iter == MAX_ITER) ? sf::Color::Black : sf::Color(255 * iter / MAX_ITER, 255 * iter / MAX_ITER, 255 * iter / MAX_ITER);
-            image.setPixel(x, y, color);
-        }
-    }
-    sf::Texture texture;
-    texture.loadFromImage(image);
-    sf::Sprite sprite(texture);
-    while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                window.close();
-        }
-        window.clear();
-        window.draw(sprite);
-        window.display();
-    }
-    free(output_serial);
-    free(output_parallel);
-    return 0;
+#include <SFML/Graphics.hpp>
+#include <omp.h>
+#include <iostream>
+#include <ctime>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#define WIDTH 800
+#define HEIGHT 800
+#define MAX_ITER 1000
+
+void compute_mandelbrot_serial(double real_min, double real_max, double imag_min, double imag_max, int width, int height, int max_iter, int *output) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            double real = real_min + (real_max - real_min) * x / width;
+            double imag = imag_min + (imag_max - imag_min) * y / height;
+            double zr = real, zi = imag;
+            int iter;
+            for (iter = 0; iter < max_iter; iter++) {
+                double zr2 = zr * zr, zi2 = zi * zi;
+                if (zr2 + zi2 > 4.0) break;
+                zi = 2.0 * zr * zi + imag;
+                zr = zr2 - zi2 + real;
+            }
+            output[y * width + x] = iter;
+        }
+    }
+}
+
+// Double-double number: value = hi + lo with |lo| <= ulp(hi) / 2, about 32 significant digits.
+struct dd {
+    double hi, lo;
+};
+
+static inline dd two_sum(double a, double b) {
+    double s = a + b;
+    double bb = s - a;
+    return {s, (a - (s - bb)) + (b - bb)};
+}
+
+static inline dd quick_two_sum(double a, double b) {
+    double s = a + b;
+    return {s, b - (s - a)};
+}
+
+static inline dd two_prod(double a, double b) {
+    double p = a * b;
+    return {p, std::fma(a, b, -p)};
+}
+
+static inline dd dd_add(dd a, dd b) {
+    dd s = two_sum(a.hi, b.hi);
+    dd t = two_sum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = quick_two_sum(s.hi, s.lo);
+    s.lo += t.lo;
+    return quick_two_sum(s.hi, s.lo);
+}
+
+static inline dd dd_mul(dd a, dd b) {
+    dd p = two_prod(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return quick_two_sum(p.hi, p.lo);
+}
+
+static inline dd dd_div(dd a, double b) {
+    double q1 = a.hi / b;
+    dd p = two_prod(q1, b);
+    dd s = two_sum(a.hi, -p.hi);
+    s.lo = s.lo - p.lo + a.lo;
+    double q2 = (s.hi + s.lo) / b;
+    return quick_two_sum(q1, q2);
+}
+
+// Parses a decimal literal such as "-0.743643887037158704752191506114774" without going through double.
+dd dd_from_string(const char *str) {
+    dd value = {0.0, 0.0};
+    bool negative = false;
+    int scale = 0;
+    const char *p = str;
+    if (*p == '-' || *p == '+') negative = (*p++ == '-');
+    bool fraction = false;
+    for (; *p; p++) {
+        if (*p == '.') {
+            fraction = true;
+        } else if (*p >= '0' && *p <= '9') {
+            value = dd_add(dd_mul(value, {10.0, 0.0}), {(double)(*p - '0'), 0.0});
+            if (fraction) scale--;
+        } else {
+            break;
+        }
+    }
+    if (*p == 'e' || *p == 'E') scale += atoi(p + 1);
+    for (; scale > 0; scale--) value = dd_mul(value, {10.0, 0.0});
+    for (; scale < 0; scale++) value = dd_div(value, 10.0);
+    if (negative) value = {-value.hi, -value.lo};
+    return value;
+}
+
+// Iterates the reference point in double-double and stores the orbit rounded to double.
+// Returns the orbit length (including Z_0 = 0); shorter than max_iter + 1 if the reference escapes.
+int compute_reference_orbit(dd center_real, dd center_imag, int max_iter, double *orbit_real, double *orbit_imag) {
+    dd zr = {0.0, 0.0}, zi = {0.0, 0.0};
+    int n = 0;
+    orbit_real[0] = 0.0;
+    orbit_imag[0] = 0.0;
+    while (n < max_iter) {
+        dd zr2 = dd_mul(zr, zr), zi2 = dd_mul(zi, zi);
+        dd zri = dd_mul(zr, zi);
+        zi = dd_add(dd_add(zri, zri), center_imag);
+        zr = dd_add(dd_add(zr2, {-zi2.hi, -zi2.lo}), center_real);
+        n++;
+        orbit_real[n] = zr.hi;
+        orbit_imag[n] = zi.hi;
+        if (zr.hi * zr.hi + zi.hi * zi.hi > 4.0) break;
+    }
+    return n + 1;
+}
+
+#define LANES 8
+
+// Perturbation renderer: one reference orbit at the view center, every pixel iterates only its
+// offset from it, delta' = (2Z + delta) * delta + dc, in plain doubles. Pixels are processed in
+// blocks of LANES so the per-iteration update vectorizes across pixels.
+// Glitch handling: when |Z + delta| < |delta| (or the reference has run out) the delta is no longer
+// a small correction to the orbit, so the pixel is rebased onto Z_0 with delta = Z + delta.
+// Returns the number of rebases performed.
+long long compute_mandelbrot_perturbation(dd center_real, dd center_imag, double real_span, int width, int height, int max_iter, int *output) {
+    std::vector<double> orbit_real(max_iter + 1), orbit_imag(max_iter + 1);
+    const int orbit_len = compute_reference_orbit(center_real, center_imag, max_iter, orbit_real.data(), orbit_imag.data());
+    const double *Zr = orbit_real.data();
+    const double *Zi = orbit_imag.data();
+    const double step = real_span / width;
+    long long rebases = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:rebases)
+    for (int y = 0; y < height; y++) {
+        for (int x0 = 0; x0 < width; x0 += LANES) {
+            double dcr[LANES], dci[LANES], dr[LANES], di[LANES];
+            int ref[LANES], iter[LANES], done[LANES];
+            for (int l = 0; l < LANES; l++) {
+                dcr[l] = (x0 + l - width / 2) * step;
+                dci[l] = (y - height / 2) * step;
+                dr[l] = dcr[l];
+                di[l] = dci[l];
+                ref[l] = 1;
+                iter[l] = max_iter;
+                done[l] = (x0 + l >= width);
+            }
+            for (int n = 0; n < max_iter; n++) {
+                int active = 0;
+                int block_rebases = 0;
+                #pragma omp simd reduction(+:active, block_rebases)
+                for (int l = 0; l < LANES; l++) {
+                    if (done[l]) continue;
+                    double zr = Zr[ref[l]] + dr[l];
+                    double zi = Zi[ref[l]] + di[l];
+                    double mag = zr * zr + zi * zi;
+                    if (mag > 4.0) {
+                        iter[l] = n;
+                        done[l] = 1;
+                        continue;
+                    }
+                    if (mag < dr[l] * dr[l] + di[l] * di[l] || ref[l] == orbit_len - 1) {
+                        dr[l] = zr;
+                        di[l] = zi;
+                        ref[l] = 0;
+                        block_rebases++;
+                    }
+                    double ar = 2.0 * Zr[ref[l]] + dr[l];
+                    double ai = 2.0 * Zi[ref[l]] + di[l];
+                    double ndr = ar * dr[l] - ai * di[l] + dcr[l];
+                    di[l] = ar * di[l] + ai * dr[l] + dci[l];
+                    dr[l] = ndr;
+                    ref[l]++;
+                    active++;
+                }
+                rebases += block_rebases;
+                if (active == 0) break;
+            }
+            for (int l = 0; l < LANES && x0 + l < width; l++) {
+                output[y * width + x0 + l] = iter[l];
+            }
+        }
+    }
+    return rebases;
+}
+
+// Parallel version of compute_mandelbrot_serial with a larger bailout, producing a continuous
+// (normalized-iteration) escape value instead of the integer count. Points inside the set get max_iter.
+void compute_mandelbrot_parallel(double real_min, double real_max, double imag_min, double imag_max, int width, int height, int max_iter, float *output) {
+    #pragma omp parallel for schedule(dynamic)
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            double real = real_min + (real_max - real_min) * x / width;
+            double imag = imag_min + (imag_max - imag_min) * y / height;
+            double zr = real, zi = imag;
+            double mag = zr * zr + zi * zi;
+            int iter;
+            for (iter = 0; iter < max_iter; iter++) {
+                double zr2 = zr * zr, zi2 = zi * zi;
+                mag = zr2 + zi2;
+                if (mag > 65536.0) break;
+                zi = 2.0 * zr * zi + imag;
+                zr = zr2 - zi2 + real;
+            }
+            float mu = (float)max_iter;
+            if (iter < max_iter) {
+                mu = (float)(iter + 1 - std::log2(0.5 * std::log(mag)));
+                mu = std::min(std::max(mu, 0.0f), (float)max_iter - 1.0f);
+            }
+            output[y * width + x] = mu;
+        }
+    }
+}
+
+#define PALETTE_STOPS 5
+
+// Gradient sampled by the equalized CDF: deep blue -> white -> orange -> dark.
+static const unsigned char palette_stops[PALETTE_STOPS][3] = {
+    {0, 7, 100}, {32, 107, 203}, {237, 255, 255}, {255, 170, 0}, {40, 2, 0}
+};
+
+static void palette_lookup(float t, unsigned char *rgba) {
+    float pos = t * (PALETTE_STOPS - 1);
+    int i = std::min((int)pos, PALETTE_STOPS - 2);
+    float f = pos - i;
+    for (int c = 0; c < 3; c++)
+        rgba[c] = (unsigned char)(palette_stops[i][c] + f * (palette_stops[i + 1][c] - palette_stops[i][c]));
+    rgba[3] = 255;
+}
+
+// Histogram-equalized coloring of escape values (integer counts or smooth values).
+// Bins are privatized per thread by the array reduction, the cumulative distribution is turned
+// into a max_iter + 1 entry RGBA lookup table, and pixels are mapped into `rgba` in parallel,
+// interpolating between adjacent table entries by the fractional part of the escape value.
+template <typename T>
+void color_histogram_equalized(const T *escape, int width, int height, int max_iter, unsigned char *rgba) {
+    const long long pixels = (long long)width * height;
+    std::vector<long long> histogram(max_iter + 1, 0);
+    long long *hist = histogram.data();
+
+    #pragma omp parallel for reduction(+:hist[:max_iter + 1])
+    for (long long i = 0; i < pixels; i++) {
+        hist[(int)escape[i]]++;
+    }
+
+    const long long escaped = pixels - hist[max_iter];
+    std::vector<unsigned char> lut(4 * (max_iter + 1));
+    long long cumulative = 0;
+    for (int i = 0; i < max_iter; i++) {
+        cumulative += hist[i];
+        palette_lookup(escaped ? (float)cumulative / escaped : 0.0f, &lut[4 * i]);
+    }
+    lut[4 * max_iter] = lut[4 * max_iter + 1] = lut[4 * max_iter + 2] = 0;
+    lut[4 * max_iter + 3] = 255;
+
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < pixels; i++) {
+        float e = (float)escape[i];
+        int bin = (int)e;
+        unsigned char *out = rgba + 4 * i;
+        if (bin >= max_iter) {
+            out[0] = out[1] = out[2] = 0;
+            out[3] = 255;
+            continue;
+        }
+        const unsigned char *lo = &lut[4 * bin];
+        const unsigned char *hi = &lut[4 * std::min(bin + 1, max_iter - 1)];
+        float f = e - bin;
+        for (int c = 0; c < 4; c++)
+            out[c] = (unsigned char)(lo[c] + f * (hi[c] - lo[c]));
+    }
+}
+
+void display_rgba(const unsigned char *rgba, int width, int height) {
+    sf::RenderWindow window(sf::VideoMode(width, height), "Mandelbrot Set");
+    sf::Texture texture;
+    texture.create(width, height);
+    texture.update(rgba);
+    sf::Sprite sprite(texture);
+    while (window.isOpen()) {
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed)
+                window.close();
+        }
+        window.clear();
+        window.draw(sprite);
+        window.display();
+    }
+}
+
+// Usage: ./mandelbrot --deep <center_real> <center_imag> <real_span> [max_iter]
+int run_deep_zoom(int argc, char *argv[]) {
+    if (argc < 5) {
+        std::cerr << "usage: " << argv[0] << " --deep <center_real> <center_imag> <real_span> [max_iter]\n";
+        return 1;
+    }
+    dd center_real = dd_from_string(argv[2]);
+    dd center_imag = dd_from_string(argv[3]);
+    double real_span = atof(argv[4]);
+    int max_iter = (argc > 5) ? atoi(argv[5]) : MAX_ITER;
+    if (!(real_span > 0.0) || max_iter < 1) {
+        std::cerr << "usage: " << argv[0] << " --deep <center_real> <center_imag> <real_span> [max_iter]\n"
+                  << "real_span and max_iter must be positive\n";
+        return 1;
+    }
+
+    int *output = (int *)malloc(WIDTH * HEIGHT * sizeof(int));
+    double start = omp_get_wtime();
+    long long rebases = compute_mandelbrot_perturbation(center_real, center_imag, real_span, WIDTH, HEIGHT, max_iter, output);
+    double end = omp_get_wtime();
+    std::cout << "Perturbation Time: " << end - start << " seconds\n";
+    std::cout << "Rebases: " << rebases << "\n";
+
+    std::vector<unsigned char> rgba(4 * WIDTH * HEIGHT);
+    color_histogram_equalized(output, WIDTH, HEIGHT, max_iter, rgba.data());
+    display_rgba(rgba.data(), WIDTH, HEIGHT);
+    free(output);
+    return 0;
+}
+
+// Usage: ./mandelbrot --headless <width> <height> <output.ppm> [strip_rows] [max_iter]
+// Renders in horizontal strips without a window. Workers claim strips in order and fill one of
+// `slots` strip buffers; the writer thread streams the buffers to disk in strip order. A worker
+// may run at most `slots` strips ahead of the writer, so memory stays O(slots * strip) no matter
+// how large the image is.
+int run_headless(int argc, char *argv[]) {
+    if (argc < 5) {
+        std::cerr << "usage: " << argv[0] << " --headless <width> <height> <output.ppm> [strip_rows] [max_iter]\n";
+        return 1;
+    }
+    const int width = atoi(argv[2]);
+    const int height = atoi(argv[3]);
+    const char *path = argv[4];
+    const int strip_rows = (argc > 5) ? atoi(argv[5]) : 64;
+    const int max_iter = (argc > 6) ? atoi(argv[6]) : MAX_ITER;
+    if (width < 1 || height < 1 || strip_rows < 1 || max_iter < 1) {
+        std::cerr << "usage: " << argv[0] << " --headless <width> <height> <output.ppm> [strip_rows] [max_iter]\n"
+                  << "width, height, strip_rows and max_iter must be positive\n";
+        return 1;
+    }
+    const int num_strips = (height + strip_rows - 1) / strip_rows;
+    const int num_workers = std::max(1u, std::thread::hardware_concurrency());
+    const int slots = 2 * num_workers;
+
+    const double real_min = -2.0, real_max = 1.0;
+    const double imag_span = (real_max - real_min) * height / width;
+    const double imag_min = -imag_span / 2;
+
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        std::cerr << "cannot open " << path << "\n";
+        return 1;
+    }
+    fprintf(out, "P6\n%d %d\n255\n", width, height);
+
+    std::vector<std::vector<unsigned char>> slot_pixels(slots, std::vector<unsigned char>((size_t)width * strip_rows * 3));
+    std::vector<int> slot_strip(slots, -1);
+    std::mutex slot_mutex;
+    std::condition_variable slot_free_cv, slot_ready_cv;
+    std::atomic<int> next_strip(0);
+    int next_to_write = 0;
+    bool write_failed = false;  // writer thread only until it is joined
+
+    auto worker = [&]() {
+        std::vector<int> iterations((size_t)width * strip_rows);
+        while (true) {
+            int strip = next_strip.fetch_add(1);
+            if (strip >= num_strips) break;
+            {
+                std::unique_lock<std::mutex> lock(slot_mutex);
+                slot_free_cv.wait(lock, [&] { return strip < next_to_write + slots; });
+            }
+            int y0 = strip * strip_rows;
+            int rows = std::min(strip_rows, height - y0);
+            double strip_imag_min = imag_min + imag_span * y0 / height;
+            double strip_imag_max = imag_min + imag_span * (y0 + rows) / height;
+            compute_mandelbrot_serial(real_min, real_max, strip_imag_min, strip_imag_max, width, rows, max_iter, iterations.data());
+
+            unsigned char *pixels = slot_pixels[strip % slots].data();
+            for (size_t i = 0; i < (size_t)width * rows; i++) {
+                int iter = iterations[i];
+                unsigned char v = (iter == max_iter) ? 0 : (unsigned char)(255 * iter / max_iter);
+                pixels[3 * i] = pixels[3 * i + 1] = pixels[3 * i + 2] = v;
+            }
+            {
+                std::lock_guard<std::mutex> lock(slot_mutex);
+                slot_strip[strip % slots] = strip;
+            }
+            slot_ready_cv.notify_one();
+        }
+    };
+
+    auto writer = [&]() {
+        for (int strip = 0; strip < num_strips; strip++) {
+            int slot = strip % slots;
+            {
+                std::unique_lock<std::mutex> lock(slot_mutex);
+                slot_ready_cv.wait(lock, [&] { return slot_strip[slot] == strip; });
+            }
+            int rows = std::min(strip_rows, height - strip * strip_rows);
+            size_t bytes = (size_t)width * rows * 3;
+            if (!write_failed && fwrite(slot_pixels[slot].data(), 1, bytes, out) != bytes)
+                write_failed = true;
+            {
+                std::lock_guard<std::mutex> lock(slot_mutex);
+                next_to_write = strip + 1;
+            }
+            slot_free_cv.notify_all();
+        }
+    };
+
+    double start = omp_get_wtime();
+    std::thread writer_thread(writer);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < num_workers; i++) workers.emplace_back(worker);
+    for (auto &t : workers) t.join();
+    writer_thread.join();
+    double end = omp_get_wtime();
+    if (fclose(out) != 0) write_failed = true;
+    if (write_failed) {
+        std::cerr << "error writing " << path << "\n";
+        return 1;
+    }
+
+    std::cout << "Rendered " << width << "x" << height << " in " << num_strips << " strips using "
+              << num_workers << " workers: " << end - start << " seconds\n";
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--deep") == 0)
+        return run_deep_zoom(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--headless") == 0)
+        return run_headless(argc, argv);
+
+    int *output_serial = (int *)malloc(WIDTH * HEIGHT * sizeof(int));
+    float *output_parallel = (float *)malloc(WIDTH * HEIGHT * sizeof(float));
+
+    clock_t start_serial, end_serial;
+    double time_serial;
+    start_serial = clock();
+    compute_mandelbrot_serial(-2.0, 1.0, -1.5, 1.5, WIDTH, HEIGHT, MAX_ITER, output_serial);
+    end_serial = clock();
+    time_serial = ((double) (end_serial - start_serial)) / CLOCKS_PER_SEC;
+
+    double start_parallel, end_parallel;
+    double time_parallel;
+    start_parallel = omp_get_wtime();
+    compute_mandelbrot_parallel(-2.0, 1.0, -1.5, 1.5, WIDTH, HEIGHT, MAX_ITER, output_parallel);
+    end_parallel = omp_get_wtime();
+    time_parallel = end_parallel - start_parallel;
+
+    double speedup = time_serial / time_parallel;
+    std::cout << "Serial Time: " << time_serial << " seconds\n";
+    std::cout << "Parallel Time: " << time_parallel << " seconds\n";
+    std::cout << "Speedup: " << speedup << "\n";
+    free(output_serial);
+
+    unsigned char *rgba = (unsigned char *)malloc(4 * WIDTH * HEIGHT);
+    double start_color = omp_get_wtime();
+    color_histogram_equalized(output_parallel, WIDTH, HEIGHT, MAX_ITER, rgba);
+    double end_color = omp_get_wtime();
+    std::cout << "Coloring Time: " << end_color - start_color << " seconds\n";
+    free(output_parallel);
+
+    display_rgba(rgba, WIDTH, HEIGHT);
+    free(rgba);
+    return 0;
 }
\ No newline at end of file
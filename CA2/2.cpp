@@ -1,106 +1,284 @@
-#include <SFML/Graphics.hpp>
-#include <complex>
-#include <chrono>
-#include <iostream>
-#include <omp.h>
-
-const int WIDTH = 800;
-const int HEIGHT = 800;
-const int MAX_ITER = 1000;
-
-//const std::complex<double> C(-0.8, 0.156);
-//const std::complex<double> C(-0.7, 0.27015);
-//const std::complex<double> C(0.355, 0.355);
-const std::complex<double> C(-0.5, 0.5);
-
-sf::Color getColor(int iter) {
-    return sf::Color(iter % 256, (iter * 5) % 256, (iter * 15) % 256);
-}
-
-int julia(double real, double imag) {
-    std::complex<double> z(real, imag);
-    int iter = 0;
-    while (abs(z) <= 2 && iter < MAX_ITER) {
-        z = z * z + C;
-        ++iter;
-    }
-    return iter;
-}
-
-void computeSerial(sf::Image& image) {
-    for (int y = 0; y < HEIGHT; ++y) {
-        for (int x = 0; x < WIDTH; ++x) {
-            double real = (x - WIDTH / 2.0) * 4.0 / WIDTH;
-            double imag = (y - HEIGHT / 2.0) * 4.0 / HEIGHT;
-            int iter = julia(real, imag);
-            sf::Color color = getColor(iter);
-            image.setPixel(x, y, color);
-        }
-    }
-}
-
-void computeParallel(sf::Image& image) {
-    std::vector<sf::Color> buffer(WIDTH * HEIGHT);
-    #pragma omp parallel num_threads(8)
-    {
-        #pragma omp for schedule(static) 
-        for (int y = 0; y < HEIGHT; ++y) {
-            for (int x = 0; x < WIDTH; ++x) {
-                double real = (x - WIDTH / 2.0) * 4.0 / WIDTH;
-                double imag = (y - HEIGHT / 2.0) * 4.0 / HEIGHT;
-                int iter = julia(real, imag);
-                sf::Color color = getColor(iter);
-                buffer[y * WIDTH + x] = color;
-            }
-        }
-        #pragma omp for schedule(static)
-        for (int y = 0; y < HEIGHT; ++y) {
-            for (int x = 0; x < WIDTH; ++x) {
-                image.setPixel(x, y, buffer[y * WIDTH + x]);
-            }
-        }
-    }
-}
-
-int main() {
-    sf::RenderWindow window(sf::VideoMode(WIDTH, HEIGHT), "Julia Set - Parallel vs Serial");
-
-    sf::Image serialImage, parallelImage;
-    serialImage.create(WIDTH, HEIGHT, sf::Color::Black);
-    parallelImage.create(WIDTH, HEIGHT, sf::Color::Black);
-
-    //serial
-    auto serialStart = std::chrono::high_resolution_clock::now();
-    computeSerial(serialImage);
-    auto serialEnd = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> serialTime = serialEnd - serialStart;
-    std::cout << "Serial execution time: " << serialTime.count() << " seconds\n";
-
-    //parallel
-    auto parallelStart = std::chrono::high_resolution_clock::now();
-    computeParallel(parallelImage);
-    auto parallelEnd = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> parallelTime = parallelEnd - parallelStart;
-    std::cout << "Parallel execution time: " << parallelTime.count() << " seconds\n";
-
-    double speedup = serialTime.count() / parallelTime.count();
-    std::cout << "Speedup: " << speedup << "x\n";
-
-    sf::Texture texture;
-    texture.loadFromImage(parallelImage);
-    sf::Sprite sprite(texture);
-
-    while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                window.close();
-        }
-
-        window.clear();
-        window.draw(sprite);
-        window.display();
-    }
-
-    return 0;
-}
+#include <SFML/Graphics.hpp>
+#include <complex>
+#include <chrono>
+#include <iostream>
+#include <omp.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int WIDTH = 800;
+const int HEIGHT = 800;
+const int MAX_ITER = 1000;
+
+const std::complex<double> C(-0.5, 0.5);
+
+// Default waypoints for --animate when no path file is given.
+const std::complex<double> DEFAULT_SWEEP[] = {
+    { -0.8, 0.156 }, { -0.7, 0.27015 }, { 0.355, 0.355 }, { -0.5, 0.5 }
+};
+
+const int LANES = 8;
+
+sf::Color getColor(int iter) {
+    return sf::Color(iter % 256, (iter * 5) % 256, (iter * 15) % 256);
+}
+
+// getColor for every possible iteration count, packed as RGBA8 so a pixel is a single 32-bit store.
+struct Palette {
+    alignas(64) uint32_t rgba[MAX_ITER + 1];
+
+    Palette() {
+        for (int i = 0; i <= MAX_ITER; ++i) {
+            sf::Color c = getColor(i);
+            uint8_t bytes[4] = { c.r, c.g, c.b, c.a };
+            std::memcpy(&rgba[i], bytes, 4);
+        }
+    }
+};
+
+const Palette palette;
+
+// Iterates LANES neighbouring pixels of one row in lockstep on the squared magnitude (no sqrt),
+// so the lane loop vectorizes; stops once every lane has escaped.
+void juliaBlock(double imag, int x0, std::complex<double> c, uint32_t* out) {
+    double zr[LANES], zi[LANES];
+    int iters[LANES];
+    for (int l = 0; l < LANES; ++l) {
+        zr[l] = (x0 + l - WIDTH / 2.0) * 4.0 / WIDTH;
+        zi[l] = imag;
+        iters[l] = 0;
+    }
+    for (int iter = 0; iter < MAX_ITER; ++iter) {
+        int active = 0;
+        #pragma omp simd reduction(+:active)
+        for (int l = 0; l < LANES; ++l) {
+            double zr2 = zr[l] * zr[l], zi2 = zi[l] * zi[l];
+            int inside = (zr2 + zi2 <= 4.0) && iters[l] == iter;
+            double nzi = 2.0 * zr[l] * zi[l] + c.imag();
+            double nzr = zr2 - zi2 + c.real();
+            zr[l] = inside ? nzr : zr[l];
+            zi[l] = inside ? nzi : zi[l];
+            iters[l] += inside;
+            active += inside;
+        }
+        if (active == 0) break;
+    }
+    for (int l = 0; l < LANES && x0 + l < WIDTH; ++l) {
+        out[l] = palette.rgba[iters[l]];
+    }
+}
+
+void juliaRow(int y, std::complex<double> c, uint8_t* pixels) {
+    double imag = (y - HEIGHT / 2.0) * 4.0 / HEIGHT;
+    uint32_t* row = reinterpret_cast<uint32_t*>(pixels) + (size_t)y * WIDTH;
+    for (int x = 0; x < WIDTH; x += LANES) {
+        juliaBlock(imag, x, c, row + x);
+    }
+}
+
+// `pixels` is a caller-owned, 64-byte aligned WIDTH * HEIGHT RGBA8 buffer.
+void computeSerial(uint8_t* pixels) {
+    for (int y = 0; y < HEIGHT; ++y) {
+        juliaRow(y, C, pixels);
+    }
+}
+
+void computeParallel(uint8_t* pixels) {
+    #pragma omp parallel for schedule(static) num_threads(8)
+    for (int y = 0; y < HEIGHT; ++y) {
+        juliaRow(y, C, pixels);
+    }
+}
+
+uint8_t* allocatePixels() {
+    return static_cast<uint8_t*>(std::aligned_alloc(64, (size_t)WIDTH * HEIGHT * 4));
+}
+
+void writePPM(const std::string& path, const uint8_t* pixels) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Cannot write " << path << "\n";
+        return;
+    }
+    std::fprintf(file, "P6\n%d %d\n255\n", WIDTH, HEIGHT);
+    std::vector<uint8_t> row(WIDTH * 3);
+    for (int y = 0; y < HEIGHT; ++y) {
+        const uint8_t* src = pixels + (size_t)y * WIDTH * 4;
+        for (int x = 0; x < WIDTH; ++x) {
+            row[3 * x] = src[4 * x];
+            row[3 * x + 1] = src[4 * x + 1];
+            row[3 * x + 2] = src[4 * x + 2];
+        }
+        std::fwrite(row.data(), 1, row.size(), file);
+    }
+    std::fclose(file);
+}
+
+// Piecewise-linear position along the waypoints for frame `frame` of `frames`.
+std::complex<double> sweepPoint(const std::vector<std::complex<double>>& path, int frame, int frames) {
+    if (path.size() == 1 || frames == 1) return path.front();
+    double t = (double)frame / (frames - 1) * (path.size() - 1);
+    size_t segment = std::min((size_t)t, path.size() - 2);
+    double f = t - segment;
+    return path[segment] + f * (path[segment + 1] - path[segment]);
+}
+
+// Renders frames first..first+count-1, one frame per outer thread ("group"), each frame's rows
+// split across that group's inner team. Nesting is enabled here rather than by the caller because
+// OpenMP ICVs are per thread, and from the second wave on this runs on a fresh std::thread.
+void renderWave(const std::vector<std::complex<double>>& path, int frames, int first, int count,
+                std::vector<uint8_t*>& buffers, int threadsPerGroup) {
+    omp_set_max_active_levels(2);
+    #pragma omp parallel for num_threads(count) schedule(static, 1)
+    for (int g = 0; g < count; ++g) {
+        std::complex<double> c = sweepPoint(path, first + g, frames);
+        uint8_t* pixels = buffers[g];
+        #pragma omp parallel for num_threads(threadsPerGroup) schedule(dynamic)
+        for (int y = 0; y < HEIGHT; ++y) {
+            juliaRow(y, c, pixels);
+        }
+    }
+}
+
+// Usage: ./julia --animate <frames> [path_file] [output_dir] [groups]
+// path_file holds one "real imag" waypoint per line ("-" for the default sweep). With an output
+// directory frames are written as frame_NNNNN.ppm, otherwise they are shown in a window.
+// While one wave of `groups` frames is being presented, the next wave renders into the other
+// set of buffers.
+int runAnimation(int argc, char* argv[]) {
+    int frames = (argc > 2) ? std::atoi(argv[2]) : 120;
+    std::vector<std::complex<double>> path;
+    if (argc > 3 && std::string(argv[3]) != "-") {
+        std::ifstream in(argv[3]);
+        double re, im;
+        while (in >> re >> im) path.emplace_back(re, im);
+    }
+    if (path.empty()) path.assign(std::begin(DEFAULT_SWEEP), std::end(DEFAULT_SWEEP));
+    std::string outputDir = (argc > 4) ? argv[4] : "";
+    int groups = (argc > 5) ? std::atoi(argv[5]) : 2;
+    if (frames < 1 || groups < 1) {
+        std::cerr << "Frames and groups must be positive\n";
+        return 1;
+    }
+    int threadsPerGroup = std::max(1, omp_get_max_threads() / groups);
+
+    std::vector<uint8_t*> front(groups), back(groups);
+    for (int g = 0; g < groups; ++g) {
+        front[g] = allocatePixels();
+        back[g] = allocatePixels();
+    }
+
+    sf::RenderWindow* window = nullptr;
+    sf::Texture texture;
+    sf::Sprite sprite;
+    if (outputDir.empty()) {
+        window = new sf::RenderWindow(sf::VideoMode(WIDTH, HEIGHT), "Julia Set - Parameter Sweep");
+        texture.create(WIDTH, HEIGHT);
+        sprite.setTexture(texture);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    renderWave(path, frames, 0, std::min(groups, frames), front, threadsPerGroup);
+    int presented = 0;
+    bool stopped = false;
+    for (int first = 0; first < frames && !stopped; first += groups) {
+        int count = std::min(groups, frames - first);
+        int next = first + groups;
+        std::thread renderer;
+        if (next < frames) {
+            renderer = std::thread(renderWave, std::cref(path), frames, next, std::min(groups, frames - next),
+                                   std::ref(back), threadsPerGroup);
+        }
+        for (int g = 0; g < count; ++g) {
+            if (window) {
+                sf::Event event;
+                while (window->pollEvent(event)) {
+                    if (event.type == sf::Event::Closed) {
+                        window->close();
+                        stopped = true;
+                    }
+                }
+                if (stopped) break;
+                texture.update(front[g]);
+                window->clear();
+                window->draw(sprite);
+                window->display();
+            } else {
+                char name[32];
+                std::snprintf(name, sizeof(name), "/frame_%05d.ppm", first + g);
+                writePPM(outputDir + name, front[g]);
+            }
+            ++presented;
+        }
+        if (renderer.joinable()) renderer.join();
+        std::swap(front, back);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+
+    std::cout << "Frames: " << presented << " (" << groups << " in flight, "
+              << threadsPerGroup << " threads each)\n";
+    std::cout << "Elapsed: " << elapsed.count() << " seconds\n";
+    std::cout << "Sustained FPS: " << presented / elapsed.count() << "\n";
+
+    delete window;
+    for (int g = 0; g < groups; ++g) {
+        std::free(front[g]);
+        std::free(back[g]);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--animate") == 0)
+        return runAnimation(argc, argv);
+
+    sf::RenderWindow window(sf::VideoMode(WIDTH, HEIGHT), "Julia Set - Parallel vs Serial");
+
+    uint8_t* serialPixels = allocatePixels();
+    uint8_t* parallelPixels = allocatePixels();
+
+    //serial
+    auto serialStart = std::chrono::high_resolution_clock::now();
+    computeSerial(serialPixels);
+    auto serialEnd = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> serialTime = serialEnd - serialStart;
+    std::cout << "Serial execution time: " << serialTime.count() << " seconds\n";
+
+    //parallel
+    auto parallelStart = std::chrono::high_resolution_clock::now();
+    computeParallel(parallelPixels);
+    auto parallelEnd = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> parallelTime = parallelEnd - parallelStart;
+    std::cout << "Parallel execution time: " << parallelTime.count() << " seconds\n";
+
+    double speedup = serialTime.count() / parallelTime.count();
+    std::cout << "Speedup: " << speedup << "x\n";
+
+    sf::Texture texture;
+    texture.create(WIDTH, HEIGHT);
+    texture.update(parallelPixels);
+    sf::Sprite sprite(texture);
+
+    while (window.isOpen()) {
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed)
+                window.close();
+        }
+
+        window.clear();
+        window.draw(sprite);
+        window.display();
+    }
+
+    std::free(serialPixels);
+    std::free(parallelPixels);
+    return 0;
+}
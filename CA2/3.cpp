@@ -1,136 +1,426 @@
-#include <SFML/Graphics.hpp>
-#include <cstdlib>
-#include <cmath>
-#include <iostream>
-#include <chrono>
-#include <omp.h>
-#include <random>
-#include <vector>
-#include <thread>
-
-constexpr int DISPLAY_SIZE = 800;
-constexpr int CIRCLE_RADIUS = 400;
-constexpr int NUM_POINTS = 100000;
-
-int performPiCalcParallel(sf::RenderWindow& display, const sf::CircleShape& roundShape, const sf::RectangleShape& squareShape) {
-    std::vector<sf::Vertex> pointsInsideCircle;
-    std::vector<sf::Vertex> pointsOutsideCircle;
-
-    int pointsInCircle = 0;
-
-    #pragma omp parallel num_threads(8)
-    {
-        thread_local std::mt19937 randomGen(std::random_device{}());
-        std::uniform_real_distribution<float> uniformDist(0, DISPLAY_SIZE);
-
-        std::vector<sf::Vertex> localPointsInside;
-        std::vector<sf::Vertex> localPointsOutside;
-        int localInCircle = 0;
-
-        #pragma omp for
-        for (int i = 0; i < NUM_POINTS; i++) {
-            float posX = uniformDist(randomGen);
-            float posY = uniformDist(randomGen);
-
-            float dX = posX - CIRCLE_RADIUS;
-            float dY = posY - CIRCLE_RADIUS;
-
-            if (dX * dX + dY * dY <= CIRCLE_RADIUS * CIRCLE_RADIUS) {
-                localInCircle++;
-                localPointsInside.emplace_back(sf::Vector2f(posX, posY), sf::Color::Green);
-            }
-            else {
-                localPointsOutside.emplace_back(sf::Vector2f(posX, posY), sf::Color::Red);
-            }
-        }
-
-        #pragma omp critical
-        {
-            pointsInCircle += localInCircle;
-            pointsInsideCircle.insert(pointsInsideCircle.end(), localPointsInside.begin(), localPointsInside.end());
-            pointsOutsideCircle.insert(pointsOutsideCircle.end(), localPointsOutside.begin(), localPointsOutside.end());
-        }
-    }
-
-    display.clear();
-    display.draw(roundShape);
-    display.draw(squareShape);
-    for (const auto& point : pointsInsideCircle) display.draw(&point, 1, sf::Points);
-    for (const auto& point : pointsOutsideCircle) display.draw(&point, 1, sf::Points);
-    display.display();
-    return 4.0f * pointsInCircle / NUM_POINTS;
-}
-
-int performPiCalcSerial(sf::RenderWindow& display, const sf::CircleShape& roundShape, const sf::RectangleShape& squareShape) {
-    sf::VertexArray pointsInside(sf::Points);
-    sf::VertexArray pointsOutside(sf::Points);
-
-    int pointsInCircle = 0;
-    for (int i = 0; i < NUM_POINTS; i++) {
-        float posX = static_cast<float>(rand()) / RAND_MAX * DISPLAY_SIZE;
-        float posY = static_cast<float>(rand()) / RAND_MAX * DISPLAY_SIZE;
-        float dX = posX - CIRCLE_RADIUS;
-        float dY = posY - CIRCLE_RADIUS;
-
-        if (dX * dX + dY * dY <= CIRCLE_RADIUS * CIRCLE_RADIUS) {
-            pointsInCircle++;
-            pointsInside.append(sf::Vertex(sf::Vector2f(posX, posY), sf::Color::Green));
-        }
-        else {
-            pointsOutside.append(sf::Vertex(sf::Vector2f(posX, posY), sf::Color::Red));
-        }
-
-        if (i % 10000 == 0 || i == NUM_POINTS - 1) {
-            display.clear();
-            display.draw(roundShape);
-            display.draw(squareShape);
-            display.draw(pointsInside);
-            display.draw(pointsOutside);
-            display.display();
-        }
-    }
-    return 4.0f * pointsInCircle / NUM_POINTS;
-}
-
-double computeSpeedUp(long long parallelDuration, long long serialDuration) {
-    return static_cast<double>(serialDuration) / parallelDuration;
-}
-
-int main() {
-    sf::RenderWindow display(sf::VideoMode(DISPLAY_SIZE, DISPLAY_SIZE), "Monte Carlo Simulation");
-    display.setFramerateLimit(60);
-
-    sf::CircleShape roundShape(CIRCLE_RADIUS);
-    roundShape.setFillColor(sf::Color::Transparent);
-    roundShape.setOutlineColor(sf::Color::White);
-    roundShape.setOutlineThickness(2);
-    roundShape.setPosition(0, 0);
-
-    sf::RectangleShape squareShape(sf::Vector2f(DISPLAY_SIZE, DISPLAY_SIZE));
-    squareShape.setFillColor(sf::Color::Transparent);
-    squareShape.setOutlineColor(sf::Color::White);
-    squareShape.setOutlineThickness(2);
-
-    auto serialStart = std::chrono::high_resolution_clock::now();
-    int piSerialEstimate = performPiCalcSerial(display, roundShape, squareShape);
-    auto serialEnd = std::chrono::high_resolution_clock::now();
-    auto serialDuration = std::chrono::duration_cast<std::chrono::milliseconds>(serialEnd - serialStart).count();
-
-    std::cout << "Estimated Pi (Serial): " << piSerialEstimate << std::endl;
-    std::cout << "Serial Execution Time: " << serialDuration << " ms" << std::endl;
-
-    auto parallelStart = std::chrono::high_resolution_clock::now();
-    int piParallelEstimate = performPiCalcParallel(display, roundShape, squareShape);
-    auto parallelEnd = std::chrono::high_resolution_clock::now();
-    auto parallelDuration = std::chrono::duration_cast<std::chrono::milliseconds>(parallelEnd - parallelStart).count();
-
-    std::cout << "Estimated Pi (Parallel): " << piParallelEstimate << std::endl;
-    std::cout << "Parallel Execution Time: " << parallelDuration << " ms" << std::endl;
-
-    double speedUp = computeSpeedUp(parallelDuration, serialDuration);
-    std::cout << "Speed-Up: " << speedUp << std::endl;
-
-    std::this_thread::sleep_for(std::chrono::seconds(5));
-
-    return 0;
-}
+#include <SFML/Graphics.hpp>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <chrono>
+#include <omp.h>
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include "philox.hpp"
+#include "montecarlo.hpp"
+
+constexpr int DISPLAY_SIZE = 800;
+constexpr int CIRCLE_RADIUS = 400;
+constexpr int NUM_POINTS = 100000;
+constexpr uint64_t RNG_SEED = 0x5EED0F9115ULL;
+
+// Indicator of the unit disk; integrated over [-1, 1]^2 by montecarlo::integrate it gives pi.
+struct UnitDisk {
+    double operator()(const double* x) const {
+        return x[0] * x[0] + x[1] * x[1] <= 1.0;
+    }
+
+    void batch(const double* const* x, int n, double* out) const {
+        #pragma omp simd
+        for (int j = 0; j < n; j++) {
+            out[j] = x[0][j] * x[0][j] + x[1][j] * x[1][j] <= 1.0;
+        }
+    }
+};
+
+const montecarlo::Box<2> PI_BOX = { { -1.0, -1.0 }, { 1.0, 1.0 } };
+
+// Maps an engine sample in PI_BOX to its window position and colour.
+sf::Vertex sampleVertex(double x, double y, double inside) {
+    return sf::Vertex(sf::Vector2f((float)((x + 1.0) * CIRCLE_RADIUS), (float)((y + 1.0) * CIRCLE_RADIUS)),
+                      inside != 0.0 ? sf::Color::Green : sf::Color::Red);
+}
+
+// Pi as an instance of montecarlo::integrate. Each thread keeps the vertices of the batches it
+// evaluated; they are drawn once the engine returns.
+double performPiCalcParallel(sf::RenderWindow& display, const sf::CircleShape& roundShape, const sf::RectangleShape& squareShape) {
+    std::vector<std::vector<sf::Vertex>> threadPoints(omp_get_max_threads());
+
+    montecarlo::Result result = montecarlo::integrate<2>(UnitDisk{}, PI_BOX, NUM_POINTS, RNG_SEED,
+        [&](const double* const* x, int n, const double* inside) {
+            std::vector<sf::Vertex>& points = threadPoints[omp_get_thread_num()];
+            for (int j = 0; j < n; j++) {
+                points.push_back(sampleVertex(x[0][j], x[1][j], inside[j]));
+            }
+        });
+
+    display.clear();
+    display.draw(roundShape);
+    display.draw(squareShape);
+    for (const auto& points : threadPoints) {
+        if (!points.empty()) display.draw(points.data(), points.size(), sf::Points);
+    }
+    display.display();
+    return result.estimate;
+}
+
+// The same engine instance on one thread, so batches arrive in sample order and the window is
+// redrawn every 10000 points. The estimate matches performPiCalcParallel exactly.
+double performPiCalcSerial(sf::RenderWindow& display, const sf::CircleShape& roundShape, const sf::RectangleShape& squareShape) {
+    sf::VertexArray points(sf::Points);
+    int i = 0;
+    const int savedThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+
+    montecarlo::Result result = montecarlo::integrate<2>(UnitDisk{}, PI_BOX, NUM_POINTS, RNG_SEED,
+        [&](const double* const* x, int n, const double* inside) {
+            for (int j = 0; j < n; j++) {
+                points.append(sampleVertex(x[0][j], x[1][j], inside[j]));
+                if (i % 10000 == 0 || i == NUM_POINTS - 1) {
+                    display.clear();
+                    display.draw(roundShape);
+                    display.draw(squareShape);
+                    display.draw(points);
+                    display.display();
+                }
+                i++;
+            }
+        });
+
+    omp_set_num_threads(savedThreads);
+    return result.estimate;
+}
+
+// Density mode: instead of one vertex per sample, every thread counts hits and misses into its own
+// DISPLAY_SIZE x DISPLAY_SIZE grid. The grids are summed pixel-parallel and drawn as one texture,
+// so memory is O(pixels) regardless of the sample count.
+double performPiCalcDensity(sf::RenderWindow& display, const sf::CircleShape& roundShape, const sf::RectangleShape& squareShape, long long numSamples) {
+    constexpr int GRID = DISPLAY_SIZE * DISPLAY_SIZE;
+    const int numThreads = omp_get_max_threads();
+    std::vector<uint32_t> hitGrids((size_t)numThreads * GRID, 0);
+    std::vector<uint32_t> missGrids((size_t)numThreads * GRID, 0);
+    long long pointsInCircle = 0;
+
+    #pragma omp parallel num_threads(numThreads) reduction(+:pointsInCircle)
+    {
+        uint32_t* hits = &hitGrids[(size_t)omp_get_thread_num() * GRID];
+        uint32_t* misses = &missGrids[(size_t)omp_get_thread_num() * GRID];
+
+        auto classify = [&](float posX, float posY) {
+            float dX = posX - CIRCLE_RADIUS;
+            float dY = posY - CIRCLE_RADIUS;
+            int pixel = (int)posY * DISPLAY_SIZE + (int)posX;
+            if (dX * dX + dY * dY <= CIRCLE_RADIUS * CIRCLE_RADIUS) {
+                pointsInCircle++;
+                hits[pixel]++;
+            }
+            else {
+                misses[pixel]++;
+            }
+        };
+
+        #pragma omp for schedule(static)
+        for (long long batch = 0; batch < numSamples / 8; batch++) {
+            float unitX[8], unitY[8];
+            philox::uniformPairs8(8ULL * batch, RNG_SEED, unitX, unitY);
+            for (int l = 0; l < 8; l++) {
+                classify(unitX[l] * DISPLAY_SIZE, unitY[l] * DISPLAY_SIZE);
+            }
+        }
+        #pragma omp for
+        for (long long i = numSamples / 8 * 8; i < numSamples; i++) {
+            float unitX, unitY;
+            philox::uniformPair(i, RNG_SEED, unitX, unitY);
+            classify(unitX * DISPLAY_SIZE, unitY * DISPLAY_SIZE);
+        }
+    }
+
+    uint32_t maxCount = 0;
+    #pragma omp parallel for schedule(static) reduction(max:maxCount)
+    for (int pixel = 0; pixel < GRID; pixel++) {
+        uint32_t hits = 0, misses = 0;
+        for (int t = 0; t < numThreads; t++) {
+            hits += hitGrids[(size_t)t * GRID + pixel];
+            misses += missGrids[(size_t)t * GRID + pixel];
+        }
+        hitGrids[pixel] = hits;
+        missGrids[pixel] = misses;
+        maxCount = std::max(maxCount, std::max(hits, misses));
+    }
+
+    std::vector<uint8_t> pixels(4 * GRID);
+    const float scale = maxCount ? 255.0f / std::log1p((float)maxCount) : 0.0f;
+    #pragma omp parallel for schedule(static)
+    for (int pixel = 0; pixel < GRID; pixel++) {
+        pixels[4 * pixel] = (uint8_t)(scale * std::log1p((float)missGrids[pixel]));
+        pixels[4 * pixel + 1] = (uint8_t)(scale * std::log1p((float)hitGrids[pixel]));
+        pixels[4 * pixel + 2] = 0;
+        pixels[4 * pixel + 3] = 255;
+    }
+
+    sf::Texture texture;
+    texture.create(DISPLAY_SIZE, DISPLAY_SIZE);
+    texture.update(pixels.data());
+    sf::Sprite sprite(texture);
+    display.clear();
+    display.draw(sprite);
+    display.draw(roundShape);
+    display.draw(squareShape);
+    display.display();
+    return 4.0 * pointsInCircle / numSamples;
+}
+
+enum class Sampler { Pseudo, Sobol, Halton, Stratified, Antithetic };
+
+bool parseSampler(const std::string& name, Sampler& sampler) {
+    if (name == "pseudo") sampler = Sampler::Pseudo;
+    else if (name == "sobol") sampler = Sampler::Sobol;
+    else if (name == "halton") sampler = Sampler::Halton;
+    else if (name == "stratified") sampler = Sampler::Stratified;
+    else if (name == "antithetic") sampler = Sampler::Antithetic;
+    else return false;
+    return true;
+}
+
+// Quarter-circle form of the circle test: same expectation (pi / 4) as the centered disk, but
+// monotone in both coordinates, which is what antithetic pairs need to cancel variance.
+inline int insideQuarterCircle(double u, double v) {
+    return u * u + v * v <= 1.0;
+}
+
+// Second Sobol dimension (primitive polynomial x + 1); the first is the base-2 radical inverse.
+uint32_t sobolSecondDimension(uint32_t index) {
+    uint32_t result = 0, direction = 1u << 31;
+    for (; index; index >>= 1) {
+        if (index & 1) result ^= direction;
+        direction ^= direction >> 1;
+    }
+    return result;
+}
+
+uint32_t reverseBits(uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+double radicalInverse(uint32_t index, uint32_t base) {
+    double result = 0.0, digit = 1.0 / base;
+    for (; index; index /= base, digit /= base) {
+        result += (index % base) * digit;
+    }
+    return result;
+}
+
+// Points one replicate actually evaluates: antithetic pairs need an even count and stratified
+// sampling a square grid, so both can fall short of `batchSize`.
+int pointsPerReplicate(Sampler sampler, int batchSize) {
+    switch (sampler) {
+    case Sampler::Antithetic:
+        return batchSize / 2 * 2;
+    case Sampler::Stratified: {
+        int strata = std::max(1, (int)std::sqrt((double)batchSize));
+        return strata * strata;
+    }
+    default:
+        return batchSize;
+    }
+}
+
+// One independent replicate of `batchSize` samples; returns the fraction inside the quarter circle.
+// Low-discrepancy replicates share the same points under a fresh random scramble (Sobol: digital
+// XOR shift, Halton: Cranley-Patterson rotation), so replicates are i.i.d. and their spread gives
+// an honest standard error.
+double sampleReplicate(Sampler sampler, long long replicate, int batchSize) {
+    const uint64_t base = (uint64_t)replicate * batchSize;
+    long long inside = 0;
+    const int evaluated = pointsPerReplicate(sampler, batchSize);
+    switch (sampler) {
+    case Sampler::Pseudo:
+        for (int i = 0; i < batchSize; i++) {
+            float u, v;
+            philox::uniformPair(base + i, RNG_SEED, u, v);
+            inside += insideQuarterCircle(u, v);
+        }
+        break;
+    case Sampler::Antithetic:
+        for (int i = 0; i < batchSize / 2; i++) {
+            float u, v;
+            philox::uniformPair(base / 2 + i, RNG_SEED, u, v);
+            inside += insideQuarterCircle(u, v) + insideQuarterCircle(1.0 - u, 1.0 - v);
+        }
+        break;
+    case Sampler::Stratified: {
+        int strata = std::max(1, (int)std::sqrt((double)batchSize));
+        for (int i = 0; i < evaluated; i++) {
+            float u, v;
+            philox::uniformPair(base + i, RNG_SEED, u, v);
+            inside += insideQuarterCircle((i % strata + u) / strata, (i / strata + v) / strata);
+        }
+        break;
+    }
+    case Sampler::Sobol: {
+        philox::Block shift = philox::generate({ { (uint32_t)replicate, (uint32_t)(replicate >> 32), 1, 0 } }, RNG_SEED);
+        for (int i = 0; i < batchSize; i++) {
+            double u = (reverseBits((uint32_t)i) ^ shift.v[0]) * (1.0 / 4294967296.0);
+            double v = (sobolSecondDimension((uint32_t)i) ^ shift.v[1]) * (1.0 / 4294967296.0);
+            inside += insideQuarterCircle(u, v);
+        }
+        break;
+    }
+    case Sampler::Halton: {
+        float shiftU, shiftV;
+        philox::uniformPair(replicate, RNG_SEED ^ 0x4A17'0000ULL, shiftU, shiftV);
+        for (int i = 0; i < batchSize; i++) {
+            double u = radicalInverse(i + 1, 2) + shiftU;
+            double v = radicalInverse(i + 1, 3) + shiftV;
+            inside += insideQuarterCircle(u - (u >= 1.0), v - (v >= 1.0));
+        }
+        break;
+    }
+    }
+    return (double)inside / evaluated;
+}
+
+// Convergence mode: rounds of one replicate per thread until the standard error of the pi
+// estimate drops to `tolerance` (or maxSamples is spent). Replicates are merged and the stopping
+// rule checked one at a time in index order; the rest of the final round is discarded, so the
+// stopping point and the result do not depend on the thread count.
+int runConvergence(Sampler sampler, double tolerance, int batchSize, long long maxSamples) {
+    const int numThreads = omp_get_max_threads();
+    const long long minReplicates = 8;
+    std::vector<double> roundEstimates(numThreads);
+    const int points = pointsPerReplicate(sampler, batchSize);
+    long long replicates = 0;
+    bool done = false;
+    double mean = 0.0, m2 = 0.0, standardError = 0.0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    while (!done) {
+        #pragma omp parallel for num_threads(numThreads) schedule(static, 1)
+        for (int t = 0; t < numThreads; t++) {
+            roundEstimates[t] = 4.0 * sampleReplicate(sampler, replicates + t, batchSize);
+        }
+        for (int t = 0; t < numThreads && !done; t++) {
+            replicates++;
+            double delta = roundEstimates[t] - mean;
+            mean += delta / replicates;
+            m2 += delta * (roundEstimates[t] - mean);
+            standardError = replicates > 1 ? std::sqrt(m2 / (replicates - 1) / replicates) : 0.0;
+            done = (replicates >= minReplicates && standardError <= tolerance) || replicates * points >= maxSamples;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    std::cout.precision(12);
+    std::cout << "Estimated Pi: " << mean << std::endl;
+    std::cout << "Standard Error: " << standardError << (standardError <= tolerance ? "" : " (tolerance not reached)") << std::endl;
+    std::cout << "Actual Error: " << std::fabs(mean - M_PI) << std::endl;
+    std::cout << "Samples: " << replicates * points << " (" << replicates << " replicates of " << points << ")" << std::endl;
+    std::cout << "Execution Time: " << duration << " ms" << std::endl;
+    return 0;
+}
+
+int runEngine(long long numSamples) {
+    auto start = std::chrono::high_resolution_clock::now();
+    montecarlo::Result result = montecarlo::integrate<2>(UnitDisk{}, PI_BOX, numSamples, RNG_SEED);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    std::cout.precision(10);
+    std::cout << "Estimated Pi (Engine): " << result.estimate << " +/- " << result.standardError << std::endl;
+    std::cout << "Samples: " << result.samples << std::endl;
+    std::cout << "Engine Execution Time: " << duration << " ms" << std::endl;
+    return 0;
+}
+
+double computeSpeedUp(long long parallelDuration, long long serialDuration) {
+    return static_cast<double>(serialDuration) / parallelDuration;
+}
+
+// Usage: ./montecarlo [--density <samples>]
+//        ./montecarlo --engine <samples>
+//        ./montecarlo --converge <pseudo|sobol|halton|stratified|antithetic> <tolerance> [batch_size] [max_samples]
+int main(int argc, char* argv[]) {
+    if (argc > 3 && std::strcmp(argv[1], "--converge") == 0) {
+        Sampler sampler;
+        if (!parseSampler(argv[2], sampler)) {
+            std::cerr << "Unknown sampler: " << argv[2] << std::endl;
+            return 1;
+        }
+        double tolerance = std::atof(argv[3]);
+        int batchSize = (argc > 4) ? std::atoi(argv[4]) : 4096;
+        long long maxSamples = (argc > 5) ? std::atoll(argv[5]) : 10000000000LL;
+        if (batchSize < 2) {
+            std::cerr << "Batch size must be at least 2" << std::endl;
+            return 1;
+        }
+        return runConvergence(sampler, tolerance, batchSize, maxSamples);
+    }
+    if (argc > 2 && std::strcmp(argv[1], "--engine") == 0) {
+        long long numSamples = std::atoll(argv[2]);
+        if (numSamples < 1) {
+            std::cerr << "Number of samples must be positive" << std::endl;
+            return 1;
+        }
+        return runEngine(numSamples);
+    }
+
+    if (argc > 2 && std::strcmp(argv[1], "--density") == 0 && std::atoll(argv[2]) < 1) {
+        std::cerr << "Number of samples must be positive" << std::endl;
+        return 1;
+    }
+
+    sf::RenderWindow display(sf::VideoMode(DISPLAY_SIZE, DISPLAY_SIZE), "Monte Carlo Simulation");
+    display.setFramerateLimit(60);
+
+    sf::CircleShape roundShape(CIRCLE_RADIUS);
+    roundShape.setFillColor(sf::Color::Transparent);
+    roundShape.setOutlineColor(sf::Color::White);
+    roundShape.setOutlineThickness(2);
+    roundShape.setPosition(0, 0);
+
+    sf::RectangleShape squareShape(sf::Vector2f(DISPLAY_SIZE, DISPLAY_SIZE));
+    squareShape.setFillColor(sf::Color::Transparent);
+    squareShape.setOutlineColor(sf::Color::White);
+    squareShape.setOutlineThickness(2);
+
+    if (argc > 2 && std::strcmp(argv[1], "--density") == 0) {
+        long long numSamples = std::atoll(argv[2]);
+        auto densityStart = std::chrono::high_resolution_clock::now();
+        double piDensityEstimate = performPiCalcDensity(display, roundShape, squareShape, numSamples);
+        auto densityEnd = std::chrono::high_resolution_clock::now();
+        auto densityDuration = std::chrono::duration_cast<std::chrono::milliseconds>(densityEnd - densityStart).count();
+
+        std::cout.precision(10);
+        std::cout << "Estimated Pi (Density, " << numSamples << " samples): " << piDensityEstimate << std::endl;
+        std::cout << "Density Execution Time: " << densityDuration << " ms" << std::endl;
+        std::this_thread::sleep_for(std::chrono::seconds(5));
+        return 0;
+    }
+
+    auto serialStart = std::chrono::high_resolution_clock::now();
+    double piSerialEstimate = performPiCalcSerial(display, roundShape, squareShape);
+    auto serialEnd = std::chrono::high_resolution_clock::now();
+    auto serialDuration = std::chrono::duration_cast<std::chrono::milliseconds>(serialEnd - serialStart).count();
+
+    std::cout << "Estimated Pi (Serial): " << piSerialEstimate << std::endl;
+    std::cout << "Serial Execution Time: " << serialDuration << " ms" << std::endl;
+
+    auto parallelStart = std::chrono::high_resolution_clock::now();
+    double piParallelEstimate = performPiCalcParallel(display, roundShape, squareShape);
+    auto parallelEnd = std::chrono::high_resolution_clock::now();
+    auto parallelDuration = std::chrono::duration_cast<std::chrono::milliseconds>(parallelEnd - parallelStart).count();
+
+    std::cout << "Estimated Pi (Parallel): " << piParallelEstimate << std::endl;
+    std::cout << "Parallel Execution Time: " << parallelDuration << " ms" << std::endl;
+
+    double speedUp = computeSpeedUp(parallelDuration, serialDuration);
+    std::cout << "Speed-Up: " << speedUp << std::endl;
+
+    std::this_thread::sleep_for(std::chrono::seconds(5));
+
+    return 0;
+}
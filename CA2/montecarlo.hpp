@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <omp.h>
+#include "philox.hpp"
+
+// Parallel Monte Carlo integration of a user functor over a D-dimensional box.
+//
+// The integrand is a template parameter, so calls inline. It must provide either
+//     double operator()(const double* x) const;                             // one point, x[0..D)
+// or, to be evaluated a whole batch at a time (e.g. with #pragma omp simd),
+//     void batch(const double* const* x, int n, double* out) const;        // x[d][0..n)
+// When both exist, batch() is used.
+//
+// Coordinates of sample i come from Philox counters {i_lo, i_hi, g, 0}, four dimensions per
+// group g, so each sample's point is fixed regardless of thread count.
+namespace montecarlo {
+
+constexpr int BATCH = 256;
+
+template <int D>
+struct Box {
+    double lo[D];
+    double hi[D];
+};
+
+struct Result {
+    double estimate;
+    double standardError;
+    long long samples;
+};
+
+template <typename F, typename = void>
+struct HasBatch : std::false_type {};
+
+template <typename F>
+struct HasBatch<F, std::void_t<decltype(std::declval<const F&>().batch(
+    std::declval<const double* const*>(), 0, std::declval<double*>()))>> : std::true_type {};
+
+template <int D>
+inline void fillBatch(const Box<D>& box, uint64_t first, int n, uint64_t seed, double (&x)[D][BATCH]) {
+    for (int j = 0; j < n; ++j) {
+        uint64_t index = first + j;
+        for (int g = 0; g * 4 < D; ++g) {
+            philox::Block b = philox::generate({ { (uint32_t)index, (uint32_t)(index >> 32), (uint32_t)g, 0 } }, seed);
+            for (int w = 0; w < 4 && g * 4 + w < D; ++w) {
+                int d = g * 4 + w;
+                x[d][j] = box.lo[d] + (box.hi[d] - box.lo[d]) * (b.v[w] * (1.0 / 4294967296.0));
+            }
+        }
+    }
+}
+
+template <int D, typename F>
+inline void evaluateBatch(const F& f, const double (&x)[D][BATCH], int n, double* out) {
+    if constexpr (HasBatch<F>::value) {
+        const double* columns[D];
+        for (int d = 0; d < D; ++d) columns[d] = x[d];
+        f.batch(columns, n, out);
+    } else {
+        for (int j = 0; j < n; ++j) {
+            double point[D];
+            for (int d = 0; d < D; ++d) point[d] = x[d][j];
+            out[j] = f(point);
+        }
+    }
+}
+
+// A non-positive sample count is rejected with an all-zero Result (samples == 0) rather than
+// dividing by zero. After each batch is evaluated, observe(x, n, values) sees its points and
+// integrand values (x[d][0..n) as for batch()). It runs on the worker thread that owns the batch,
+// so it must be safe to call concurrently; with one thread batches arrive in sample order.
+template <int D, typename F, typename Observer>
+Result integrate(const F& f, const Box<D>& box, long long samples, uint64_t seed, Observer&& observe) {
+    if (samples <= 0) return { 0.0, 0.0, 0 };
+
+    double volume = 1.0;
+    for (int d = 0; d < D; ++d) volume *= box.hi[d] - box.lo[d];
+
+    const long long batches = (samples + BATCH - 1) / BATCH;
+    double sum = 0.0, sumSq = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:sum, sumSq)
+    for (long long b = 0; b < batches; ++b) {
+        double x[D][BATCH];
+        double values[BATCH];
+        const uint64_t first = (uint64_t)b * BATCH;
+        const int n = (int)std::min<long long>(BATCH, samples - (long long)first);
+        fillBatch(box, first, n, seed, x);
+        evaluateBatch(f, x, n, values);
+        const double* columns[D];
+        for (int d = 0; d < D; ++d) columns[d] = x[d];
+        observe(columns, n, values);
+        double batchSum = 0.0, batchSumSq = 0.0;
+        #pragma omp simd reduction(+:batchSum, batchSumSq)
+        for (int j = 0; j < n; ++j) {
+            batchSum += values[j];
+            batchSumSq += values[j] * values[j];
+        }
+        sum += batchSum;
+        sumSq += batchSumSq;
+    }
+
+    const double mean = sum / samples;
+    const double variance = samples > 1 ? (sumSq - sum * mean) / (samples - 1) : 0.0;
+    return { volume * mean, volume * std::sqrt(std::max(variance, 0.0) / samples), samples };
+}
+
+template <int D, typename F>
+Result integrate(const F& f, const Box<D>& box, long long samples, uint64_t seed) {
+    return integrate<D>(f, box, samples, seed, [](const double* const*, int, const double*) {});
+}
+
+}
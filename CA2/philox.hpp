@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+// The output is a pure function of (counter, key), so sample i always sees the same numbers no
+// matter which thread draws it or in what order. Sample i uses counter {i_lo, i_hi, 0, 0} and the
+// first two output words as its x and y coordinates.
+namespace philox {
+
+constexpr uint32_t M0 = 0xD2511F53;
+constexpr uint32_t M1 = 0xCD9E8D57;
+constexpr uint32_t W0 = 0x9E3779B9;
+constexpr uint32_t W1 = 0xBB67AE85;
+constexpr int ROUNDS = 10;
+
+struct Block {
+    uint32_t v[4];
+};
+
+inline Block generate(const Block& counter, uint64_t key) {
+    uint32_t x0 = counter.v[0], x1 = counter.v[1], x2 = counter.v[2], x3 = counter.v[3];
+    uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+    for (int r = 0; r < ROUNDS; ++r) {
+        uint64_t p0 = (uint64_t)M0 * x0;
+        uint64_t p1 = (uint64_t)M1 * x2;
+        uint32_t y0 = (uint32_t)(p1 >> 32) ^ x1 ^ k0;
+        uint32_t y1 = (uint32_t)p1;
+        uint32_t y2 = (uint32_t)(p0 >> 32) ^ x3 ^ k1;
+        uint32_t y3 = (uint32_t)p0;
+        x0 = y0; x1 = y1; x2 = y2; x3 = y3;
+        k0 += W0;
+        k1 += W1;
+    }
+    return { { x0, x1, x2, x3 } };
+}
+
+// Top 24 bits as a float in [0, 1); exact, so scalar and SIMD paths agree bit for bit.
+inline float toUniform(uint32_t u) {
+    return (float)(u >> 8) * (1.0f / 16777216.0f);
+}
+
+inline void uniformPair(uint64_t index, uint64_t key, float& x, float& y) {
+    Block b = generate({ { (uint32_t)index, (uint32_t)(index >> 32), 0, 0 } }, key);
+    x = toUniform(b.v[0]);
+    y = toUniform(b.v[1]);
+}
+
+#ifdef __AVX2__
+inline void mulhilo8(__m256i a, __m256i m, __m256i& hi, __m256i& lo) {
+    __m256i even = _mm256_mul_epu32(a, m);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+inline __m256 toUniform8(__m256i u) {
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(u, 8)), _mm256_set1_ps(1.0f / 16777216.0f));
+}
+#endif
+
+// Eight consecutive samples starting at `first`: x[l], y[l] == uniformPair(first + l).
+inline void uniformPairs8(uint64_t first, uint64_t key, float* x, float* y) {
+#ifdef __AVX2__
+    alignas(32) uint32_t lo[8], hi[8];
+    for (int l = 0; l < 8; ++l) {
+        lo[l] = (uint32_t)(first + l);
+        hi[l] = (uint32_t)((first + l) >> 32);
+    }
+    __m256i x0 = _mm256_load_si256((const __m256i*)lo);
+    __m256i x1 = _mm256_load_si256((const __m256i*)hi);
+    __m256i x2 = _mm256_setzero_si256();
+    __m256i x3 = _mm256_setzero_si256();
+    uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+    const __m256i m0 = _mm256_set1_epi32((int)M0);
+    const __m256i m1 = _mm256_set1_epi32((int)M1);
+    for (int r = 0; r < ROUNDS; ++r) {
+        __m256i hi0, lo0, hi1, lo1;
+        mulhilo8(x0, m0, hi0, lo0);
+        mulhilo8(x2, m1, hi1, lo1);
+        x0 = _mm256_xor_si256(_mm256_xor_si256(hi1, x1), _mm256_set1_epi32((int)k0));
+        x1 = lo1;
+        x2 = _mm256_xor_si256(_mm256_xor_si256(hi0, x3), _mm256_set1_epi32((int)k1));
+        x3 = lo0;
+        k0 += W0;
+        k1 += W1;
+    }
+    _mm256_storeu_ps(x, toUniform8(x0));
+    _mm256_storeu_ps(y, toUniform8(x1));
+#else
+    for (int l = 0; l < 8; ++l) {
+        uniformPair(first + l, key, x[l], y[l]);
+    }
+#endif
+}
+
+}
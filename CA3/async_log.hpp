@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "spsc_ring.hpp"
+
+// Compile-time log levels: a statement below ASYNC_LOG_LEVEL is discarded by `if constexpr`, so
+// neither its arguments nor its formatting are ever evaluated. Build with e.g.
+// -DASYNC_LOG_LEVEL=ASYNC_LOG_WARN to silence the per-event output of a benchmark run.
+#define ASYNC_LOG_TRACE 0
+#define ASYNC_LOG_DEBUG 1
+#define ASYNC_LOG_INFO 2
+#define ASYNC_LOG_WARN 3
+#define ASYNC_LOG_ERROR 4
+#define ASYNC_LOG_OFF 5
+
+#ifndef ASYNC_LOG_LEVEL
+#define ASYNC_LOG_LEVEL ASYNC_LOG_INFO
+#endif
+
+#define ASYNC_LOG_ENABLED(level) ((level) >= ASYNC_LOG_LEVEL)
+#define LOG_AT(level, ...)                                         \
+    do {                                                           \
+        if constexpr (ASYNC_LOG_ENABLED(level)) {                  \
+            asynclog::write(level, __VA_ARGS__);                   \
+        }                                                          \
+    } while (0)
+#define LOG_TRACE(...) LOG_AT(ASYNC_LOG_TRACE, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(ASYNC_LOG_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(ASYNC_LOG_INFO, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(ASYNC_LOG_WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(ASYNC_LOG_ERROR, __VA_ARGS__)
+
+namespace asynclog {
+
+// Fixed-size binary record. A message longer than one record is split into chunks that share a
+// timestamp and have `more` set on all but the last, so the flusher writes them back to back.
+struct Record {
+    int64_t timestamp;
+    uint32_t thread;
+    uint32_t sequence;
+    uint16_t length;
+    uint8_t level;
+    uint8_t more;
+    char text[236];
+};
+
+static_assert(sizeof(Record) == 256, "one record is four cache lines");
+
+// What a producer does when its ring is full: drop the record and count it (the default, so
+// logging never stalls a timed run), or yield until the flusher makes room (for programs whose
+// log output is their result).
+enum class Overflow { Drop, Wait };
+
+inline std::atomic<Overflow> overflowPolicy{Overflow::Drop};
+
+inline void setOverflow(Overflow policy) {
+    overflowPolicy.store(policy, std::memory_order_relaxed);
+}
+
+// Per-thread ring. The owning thread is the only producer; the flusher is the only consumer.
+struct ThreadBuffer {
+    static constexpr size_t RECORDS = 4096;
+
+    explicit ThreadBuffer(uint32_t id) : id(id), ring(RECORDS) {}
+
+    uint32_t id;
+    uint32_t sequence = 0;
+    SpscRing<Record> ring;
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> retired{false};
+};
+
+// Owns the registry of thread buffers and the background flusher. Unless the overflow policy is
+// Wait, producers never block: a full ring drops the record and counts it. The flusher drains
+// every ring, orders the records by timestamp and writes them to stdout with one fwrite per record.
+class Logger {
+public:
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    ThreadBuffer& threadBuffer() {
+        thread_local Handle handle(*this);
+        return *handle.buffer;
+    }
+
+    // Writes out everything logged so far (by threads whose records are already in their rings).
+    void flush() { drainAll(); }
+
+    ~Logger() {
+        stopping.store(true);
+        flusher.join();
+        drainAll();
+    }
+
+private:
+    struct Handle {
+        explicit Handle(Logger& logger) : logger(logger), buffer(logger.registerThread()) {}
+        ~Handle() { buffer->retired.store(true, std::memory_order_release); }
+
+        Logger& logger;
+        ThreadBuffer* buffer;
+    };
+
+    Logger() : flusher([this] { run(); }) {}
+
+    ThreadBuffer* registerThread() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers.push_back(new ThreadBuffer(nextThreadId++));
+        return buffers.back();
+    }
+
+    void run() {
+        while (!stopping.load()) {
+            if (!drainAll()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    // Only one drain runs at a time, which keeps each ring single-consumer. A buffer whose thread
+    // has exited is checked for retirement before its last drain, then freed.
+    bool drainAll() {
+        std::lock_guard<std::mutex> drainLock(drainMutex);
+        std::vector<ThreadBuffer*> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            snapshot = buffers;
+        }
+        pending.clear();
+        std::vector<ThreadBuffer*> finished;
+        uint64_t dropped = 0;
+        for (ThreadBuffer* buffer : snapshot) {
+            bool retired = buffer->retired.load(std::memory_order_acquire);
+            Record record;
+            while (buffer->ring.tryPop(record)) {
+                pending.push_back(record);
+            }
+            dropped += buffer->dropped.exchange(0);
+            if (retired) finished.push_back(buffer);
+        }
+        std::stable_sort(pending.begin(), pending.end(), [](const Record& a, const Record& b) {
+            if (a.timestamp != b.timestamp) return a.timestamp < b.timestamp;
+            if (a.thread != b.thread) return a.thread < b.thread;
+            return a.sequence < b.sequence;
+        });
+        for (const Record& record : pending) {
+            fwrite(record.text, 1, record.length, stdout);
+            if (!record.more) fputc('\n', stdout);
+        }
+        if (dropped > 0) {
+            fprintf(stdout, "[log] %llu records dropped (ring full)\n",
+                    (unsigned long long)dropped);
+        }
+        if (!pending.empty() || dropped > 0) fflush(stdout);
+        if (!finished.empty()) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (ThreadBuffer* buffer : finished) {
+                buffers.erase(std::find(buffers.begin(), buffers.end(), buffer));
+                delete buffer;
+            }
+        }
+        return !pending.empty();
+    }
+
+    std::mutex registryMutex;
+    std::vector<ThreadBuffer*> buffers;
+    uint32_t nextThreadId = 0;
+    std::mutex drainMutex;
+    std::vector<Record> pending;
+    std::atomic<bool> stopping{false};
+    std::thread flusher;
+};
+
+// Appends `length` bytes of text as one message, split over as many records as it needs. Under
+// Overflow::Drop the message is kept or dropped whole: a partly queued message would leave a
+// chunk with `more` set and glue the next line onto it.
+inline void writeText(int level, const char* text, size_t length) {
+    ThreadBuffer& buffer = Logger::instance().threadBuffer();
+    const size_t chunks = std::max<size_t>(1, (length + sizeof(Record::text) - 1) / sizeof(Record::text));
+    if (overflowPolicy.load(std::memory_order_relaxed) == Overflow::Drop && !buffer.ring.hasRoom(chunks)) {
+        buffer.dropped.fetch_add(chunks, std::memory_order_relaxed);
+        return;
+    }
+    Record record;
+    record.timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    record.thread = buffer.id;
+    record.level = (uint8_t)level;
+    do {
+        size_t chunk = std::min(length, sizeof(record.text));
+        std::memcpy(record.text, text, chunk);
+        record.length = (uint16_t)chunk;
+        record.more = chunk < length;
+        record.sequence = buffer.sequence++;
+        while (!buffer.ring.tryPush(record)) {
+            std::this_thread::yield();
+        }
+        text += chunk;
+        length -= chunk;
+    } while (length > 0);
+}
+
+// printf-style message; the trailing newline is added by the flusher.
+__attribute__((format(printf, 2, 3)))
+inline void write(int level, const char* format, ...) {
+    char text[1024];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0) return;
+    writeText(level, text, std::min((size_t)length, sizeof(text) - 1));
+}
+
+inline void flush() { Logger::instance().flush(); }
+
+} // namespace asynclog
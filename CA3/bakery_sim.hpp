@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Discrete-event loop on a virtual clock (microseconds, like the real-time bakeries). Events run in
+// time order, ties in the order they were scheduled, so a simulation is fully deterministic.
+// Nothing sleeps: an hour of baking costs only as much as the events in it.
+class EventLoop {
+public:
+    long long now() const { return currentTime; }
+
+    void at(long long time, std::function<void()> action) {
+        events.push_back({ time, nextSequence++, std::move(action) });
+        std::push_heap(events.begin(), events.end(), later);
+    }
+
+    void after(long long delay, std::function<void()> action) {
+        at(currentTime + delay, std::move(action));
+    }
+
+    void run() {
+        while (!events.empty()) {
+            std::pop_heap(events.begin(), events.end(), later);
+            Event event = std::move(events.back());
+            events.pop_back();
+            currentTime = event.time;
+            event.action();
+        }
+    }
+
+private:
+    struct Event {
+        long long time;
+        long long sequence;
+        std::function<void()> action;
+    };
+
+    static bool later(const Event& a, const Event& b) {
+        return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+    }
+
+    std::vector<Event> events;
+    long long currentTime = 0;
+    long long nextSequence = 0;
+};
@@ -1,35 +1,59 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <map>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
+#include "order_queue.hpp"
+#include "oven_manager.hpp"
+#include "bakery_sim.hpp"
+#include "latency_histogram.hpp"
+#include "task_runtime.hpp"
+#include "order_loader.hpp"
+#include "async_log.hpp"
+#include <atomic>
+#include <chrono>
 #include <pthread.h>
 #include <unistd.h>
 #include <cmath>
 #include <iomanip>
+#include <algorithm>
+#include <memory>
+#include <deque>
+#include <functional>
+#include <random>
 
 using namespace std;
 
 const int BREAD_BAKING_TIME = 2000000;
 const int MAX_BREADS_PER_CUSTOMER = 15;
+// EDF deadline: two baking rounds per ten breads of the order, counted from when it was placed.
+const int DEADLINE_BAKES_PER_10_BREADS = 2;
 
-map<string, int> customerOrders;
-queue<string> signalQueue;
-map<string, long long> orderStartTimes;
+// Completion slot of one customer's order: bakers add delivered breads and wake only this
+// customer, who sleeps on the counter itself (futex-backed atomic wait) instead of a shared CV.
+// readyTime is written before the last batch is published, so the woken customer can read it.
+// In task mode the customer is a coroutine and waits on `ready` instead. Slots are indexed by
+// customer id and padded to a cache line so bakers finishing neighbouring orders do not collide.
+// The customer keeps its own pickup delay here (-1 until it has picked up); mergePickupDelays
+// folds them into stageLatencies once every customer has finished.
+struct alignas(64) OrderSlot {
+    atomic<int> delivered{0};
+    int needed = 0;
+    long long readyTime = 0;
+    long long pickupDelay = -1;
+    AsyncEvent ready;
+};
+
+// Customers are identified by their input position; names are only used for printing.
+vector<string> customerNames;
+vector<int> customerBreads;
+vector<OrderSlot> orderSlots;
+MPMCQueue<OrderRecord> orderQueue(1024);
 vector<double> orderDurations;
-map<string, vector<string>> sharedSpace;
-mutex storageMutex;
-mutex signalMutex;
-mutex ovenMutex;
+StageLatencies stageLatencies;
 mutex timeMutex;
-condition_variable signalCV;
-condition_variable ovenCV;
-condition_variable pickupCV;
-int currentOvenUsage = 0;
 int ovenCapacity = 0;
-bool bakeryOpen = true;
+unique_ptr<OvenManager> oven;
 
 long long getCurrentTimeMicros() {
     using namespace std::chrono;
@@ -60,6 +84,13 @@ double calculateStdDev(const vector<double>& times, double mean) {
     return sqrt(variance);
 }
 
+double calculatePercentile(vector<double> times, double fraction) {
+    if (times.empty()) return 0.0;
+    size_t rank = min(times.size() - 1, (size_t)ceil(fraction * times.size()) - 1);
+    nth_element(times.begin(), times.begin() + rank, times.end());
+    return times[rank];
+}
+
 void printStatistics(const vector<double>& deliveryTimes) {
     double mean = calculateMean(deliveryTimes);
     double stdDev = calculateStdDev(deliveryTimes, mean);
@@ -67,14 +98,16 @@ void printStatistics(const vector<double>& deliveryTimes) {
     cout << std::fixed << std::setprecision(2);
     cout << "Mean: " << mean << "\n";
     cout << "Standard deviation: " << stdDev << "\n";
+    cout << "P99: " << calculatePercentile(deliveryTimes, 0.99) << "\n";
 }
 
-void getInput(int &numCustomers, int &numBakers, vector<string> &customerNames, map<string, int> &customerOrders) {
+void getInput(int &numCustomers, int &numBakers, vector<string> &customerNames, vector<int> &customerBreads) {
     cout << "number of customers: ";
     cin >> numCustomers;
     cout << "number of bakers: ";
     cin >> numBakers;
     customerNames.resize(numCustomers);
+    customerBreads.resize(numCustomers);
     for (int i = 0; i < numCustomers; ++i) {
         cout << "customer name and order: ";
         cin >> customerNames[i];
@@ -84,116 +117,491 @@ void getInput(int &numCustomers, int &numBakers, vector<string> &customerNames,
             cout << "Maximum bread order is " << MAX_BREADS_PER_CUSTOMER << ". try again " << customerNames[i] << ": ";
             cin >> breads;
         }
-        customerOrders[customerNames[i]] = breads;
+        customerBreads[i] = breads;
+    }
+}
+
+long long orderDeadline(long long placed, int breads) {
+    return placed + (long long)DEADLINE_BAKES_PER_10_BREADS * BREAD_BAKING_TIME * ((breads + 9) / 10);
+}
+
+struct SimulationResult {
+    vector<double> orderDurations;
+    double utilization = 0.0;
+    long long makespan = 0;
+};
+
+// The threaded bakery on a virtual clock. Orders arrive at their offsets in `arrivals` (all at
+// time 0 if it is empty) and queue in arrival order; an idle baker takes the next one and requests
+// oven space batch by batch from the same OvenAllocator the threaded oven wraps, so the policies
+// schedule exactly as in the real run.
+SimulationResult simulateBakery(const vector<int>& orders, const vector<long long>& arrivals, int numBakers,
+                                int capacity, OvenPolicy policy, bool packing) {
+    EventLoop loop;
+    OvenAllocator allocator(capacity, policy, packing);
+    SimulationResult result;
+    result.orderDurations.reserve(orders.size());
+    auto arrivalOf = [&](int orderId) { return arrivals.empty() ? 0LL : arrivals[orderId]; };
+    deque<int> waiting;
+    deque<int> idleBakers;
+    vector<OvenRequest> requests(numBakers);
+    vector<int> currentOrder(numBakers), remainingBreads(numBakers);
+
+    function<void(int)> takeOrder;
+    auto requestBatch = [&](int bakerId) {
+        OvenRequest& request = requests[bakerId];
+        request.want = min(remainingBreads[bakerId], capacity);
+        request.jobSize = remainingBreads[bakerId];
+        request.deadline = orderDeadline(arrivalOf(currentOrder[bakerId]), orders[currentOrder[bakerId]]);
+        allocator.submit(&request);
+    };
+    function<void()> grantOven = [&]() {
+        allocator.grant(loop.now(), [&](OvenRequest* request) {
+            int bakerId = request - requests.data();
+            int batch = request->granted;
+            loop.after(BREAD_BAKING_TIME, [&, bakerId, batch]() {
+                allocator.release(loop.now(), batch);
+                grantOven();
+                remainingBreads[bakerId] -= batch;
+                if (remainingBreads[bakerId] > 0) {
+                    requestBatch(bakerId);
+                    grantOven();
+                } else {
+                    result.orderDurations.push_back((loop.now() - arrivalOf(currentOrder[bakerId])) / 1000000.0);
+                    takeOrder(bakerId);
+                }
+            });
+        });
+    };
+    takeOrder = [&](int bakerId) {
+        while (!waiting.empty()) {
+            int orderId = waiting.front();
+            waiting.pop_front();
+            if (orders[orderId] <= 0) {
+                result.orderDurations.push_back((loop.now() - arrivalOf(orderId)) / 1000000.0);
+                continue;
+            }
+            currentOrder[bakerId] = orderId;
+            remainingBreads[bakerId] = orders[orderId];
+            requestBatch(bakerId);
+            grantOven();
+            return;
+        }
+        idleBakers.push_back(bakerId);
+    };
+    // Each arrival schedules the next one, so the heap holds one pending arrival at a time.
+    function<void(int)> arrive = [&](int orderId) {
+        waiting.push_back(orderId);
+        if (!idleBakers.empty()) {
+            int bakerId = idleBakers.front();
+            idleBakers.pop_front();
+            takeOrder(bakerId);
+        }
+        if (orderId + 1 < (int)orders.size()) {
+            loop.at(arrivalOf(orderId + 1), [&, orderId]() { arrive(orderId + 1); });
+        }
+    };
+    for (int i = 0; i < numBakers; ++i) {
+        idleBakers.push_back(i);
+    }
+    if (!orders.empty()) {
+        loop.at(arrivalOf(0), [&]() { arrive(0); });
+    }
+    loop.run();
+    result.makespan = loop.now();
+    result.utilization = allocator.utilization(0, loop.now());
+    return result;
+}
+
+vector<int> randomOrders(int numCustomers, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> breads(1, MAX_BREADS_PER_CUSTOMER);
+    vector<int> orders(numCustomers);
+    for (int& order : orders) {
+        order = breads(rng);
+    }
+    return orders;
+}
+
+void printSimulation(const SimulationResult& result, OvenPolicy policy, bool packing) {
+    cout << "All orders are complete (simulated).\n";
+    printStatistics(result.orderDurations);
+    cout << "Oven policy: " << ovenPolicyName(policy) << (packing ? " with packing" : "") << "\n";
+    cout << "Oven utilization: " << 100.0 * result.utilization << "%\n";
+    cout << "Makespan: " << result.makespan / 1000000.0 << " s\n";
+}
+
+// Offered load against what the oven can bake, and the throughput actually achieved. Past 100%
+// of oven capacity the bakery is saturated: queues and latencies grow for as long as the load lasts.
+void printLoad(const vector<int>& orders, const vector<long long>& arrivals, const ArrivalProcess& process,
+               long long makespan, int capacity) {
+    long long totalBreads = 0;
+    for (int breads : orders) {
+        totalBreads += breads;
+    }
+    double ovenBreadsPerSecond = capacity * 1000000.0 / BREAD_BAKING_TIME;
+    double span = arrivals.empty() ? 0.0 : arrivals.back() / 1000000.0;
+    cout << "Arrivals: " << arrivalProcessName(process) << "\n";
+    if (span > 0.0) {
+        cout << "Offered load: " << orders.size() / span << " orders/s, " << totalBreads / span << " breads/s ("
+             << 100.0 * totalBreads / span / ovenBreadsPerSecond << "% of oven capacity)\n";
+    }
+    if (makespan > 0) {
+        cout << "Throughput: " << orders.size() / (makespan / 1000000.0) << " orders/s\n";
+    }
+}
+
+// Capacity planning: one random workload simulated for every baker count up to maxBakers and
+// for several oven sizes per baker.
+void runSweep(int numCustomers, int maxBakers, unsigned seed, OvenPolicy policy, bool packing) {
+    const int breadsPerBaker[] = { 5, 10, 15, 20 };
+    vector<int> orders = randomOrders(numCustomers, seed);
+    cout << "Oven policy: " << ovenPolicyName(policy) << (packing ? " with packing" : "") << "\n";
+    cout << setw(8) << "bakers" << setw(10) << "capacity" << setw(12) << "mean(s)" << setw(12) << "p99(s)"
+         << setw(10) << "util(%)" << setw(14) << "makespan(s)" << "\n";
+    cout << std::fixed << std::setprecision(2);
+    for (int numBakers = 1; numBakers <= maxBakers; ++numBakers) {
+        for (int perBaker : breadsPerBaker) {
+            SimulationResult result = simulateBakery(orders, {}, numBakers, perBaker * numBakers, policy, packing);
+            cout << setw(8) << numBakers << setw(10) << perBaker * numBakers
+                 << setw(12) << calculateMean(result.orderDurations)
+                 << setw(12) << calculatePercentile(result.orderDurations, 0.99)
+                 << setw(10) << 100.0 * result.utilization
+                 << setw(14) << result.makespan / 1000000.0 << "\n";
+        }
     }
 }
 
 void* bakerThread(void* arg) {
     int bakerId = *(int*)arg;
+    StageLatencies latencies;
     while (true) {
-        string customerName;
-        {
-            unique_lock<mutex> lock(signalMutex);
-            signalCV.wait(lock, [] {
-                return !signalQueue.empty() || !bakeryOpen;
-            });
-            if (signalQueue.empty() && !bakeryOpen) {
-                break;
-            }
-            if (!signalQueue.empty()) {
-                customerName = signalQueue.front();
-                signalQueue.pop();
-            }
+        OrderRecord order;
+        if (!orderQueue.pop(order)) {
+            break;
         }
-        if (!customerName.empty()) {
-            int breadsToBake = customerOrders[customerName];
-            cout << "Baker " << bakerId + 1 << " is preparing order for " << customerName
-                 << " with " << breadsToBake << " breads.\n";
-            int remainingBreads = breadsToBake;
-            while (remainingBreads > 0) {
-                unique_lock<mutex> lock(ovenMutex);
-                int batchToBake = min(remainingBreads, ovenCapacity - currentOvenUsage);
-                ovenCV.wait(lock, [batchToBake] {
-                    return currentOvenUsage + batchToBake <= ovenCapacity;
-                });
-                currentOvenUsage += batchToBake;
-                lock.unlock();
-                cout << "Baker " << bakerId + 1 << " is baking " << batchToBake << " breads for " 
-                     << customerName << ".\n";
-                usleep(BREAD_BAKING_TIME);
-                {
-                    lock_guard<mutex> sLock(storageMutex);
-                    for (int i = 0; i < batchToBake; ++i) {
-                        int breadIndex = (breadsToBake - remainingBreads + i + 1);
-                        string breadName = "Bread " + to_string(breadIndex);
-                        sharedSpace[customerName].push_back(breadName);
-                    }
-                    pickupCV.notify_all();
-                }
-                {
-                    lock_guard<mutex> ovenLock(ovenMutex);
-                    currentOvenUsage -= batchToBake;
-                    ovenCV.notify_all();
-                }
-                remainingBreads -= batchToBake;
+        latencies.queueWait.record(getCurrentTimeMicros() - order.timestamp);
+        int customerId = order.customerId;
+        const string& customerName = customerNames[customerId];
+        OrderSlot& slot = orderSlots[customerId];
+        int breadsToBake = order.breads;
+        LOG_INFO("Baker %d is preparing order for %s with %d breads.", bakerId + 1, customerName.c_str(), breadsToBake);
+        long long deadline = orderDeadline(order.timestamp, breadsToBake);
+        int remainingBreads = breadsToBake;
+        while (remainingBreads > 0) {
+            long long requested = getCurrentTimeMicros();
+            int batchToBake = oven->acquire(remainingBreads, remainingBreads, deadline, requested);
+            long long baked = getCurrentTimeMicros();
+            latencies.ovenWait.record(baked - requested);
+            LOG_INFO("Baker %d is baking %d breads for %s.", bakerId + 1, batchToBake, customerName.c_str());
+            usleep(BREAD_BAKING_TIME);
+            long long ready = getCurrentTimeMicros();
+            latencies.baking.record(ready - baked);
+            if (batchToBake == remainingBreads) {
+                slot.readyTime = ready;
             }
+            slot.delivered.fetch_add(batchToBake, memory_order_release);
+            slot.delivered.notify_one();
+            oven->release(batchToBake, getCurrentTimeMicros());
+            remainingBreads -= batchToBake;
+        }
+        {
+            long long endTime = getCurrentTimeMicros();
+            double duration = static_cast<double>(computeDurationMicros(order.timestamp, endTime)) / 1000000.0;  // In seconds
             {
-                long long endTime = getCurrentTimeMicros();
-                long long startTime = 0;
-                {
-                    lock_guard<mutex> tLock(timeMutex);
-                    startTime = orderStartTimes[customerName];
-                }
-                double duration = static_cast<double>(computeDurationMicros(startTime, endTime)) / 1000000.0;  // In seconds
-                {
-                    lock_guard<mutex> tLock(timeMutex);
-                    orderDurations.push_back(duration);
-                }
+                lock_guard<mutex> tLock(timeMutex);
+                orderDurations.push_back(duration);
             }
-            cout << "Baker " << bakerId + 1<< " has completed order for " << customerName << ".\n";
         }
+        LOG_INFO("Baker %d has completed order for %s.", bakerId + 1, customerName.c_str());
     }
+    lock_guard<mutex> tLock(timeMutex);
+    stageLatencies.merge(latencies);
     return nullptr;
 }
 
 void* customerThread(void* arg) {
-    string customerName = *(string*)arg;
+    int customerId = *(int*)arg;
+    const string& customerName = customerNames[customerId];
     long long startTime = getCurrentTimeMicros();
-    {
-        lock_guard<mutex> lock(timeMutex);
-        orderStartTimes[customerName] = startTime;
-    }
-    {
-        lock_guard<mutex> lock(signalMutex);
-        signalQueue.push(customerName);
-    }
-    signalCV.notify_one();
-    cout << "Customer " << customerName << " has signaled their order.\n";
-    {
-        unique_lock<mutex> lock(storageMutex);
-        int neededBreads = customerOrders[customerName];
-        pickupCV.wait(lock, [&] {
-            return (int)sharedSpace[customerName].size() >= neededBreads;
-        });
-        sharedSpace[customerName].clear();
-        cout << "Customer " << customerName << " has picked up their order.\n";
+    orderQueue.push({customerId, orderSlots[customerId].needed, startTime});
+    LOG_INFO("Customer %s has signaled their order.", customerName.c_str());
+    OrderSlot& slot = orderSlots[customerId];
+    int delivered = slot.delivered.load(memory_order_acquire);
+    while (delivered < slot.needed) {
+        slot.delivered.wait(delivered, memory_order_acquire);
+        delivered = slot.delivered.load(memory_order_acquire);
+    }
+    if (slot.needed > 0) {
+        slot.pickupDelay = getCurrentTimeMicros() - slot.readyTime;
     }
+    LOG_INFO("Customer %s has picked up their order.", customerName.c_str());
     return nullptr;
 }
 
-int main() {
+void mergePickupDelays() {
+    for (const OrderSlot& slot : orderSlots) {
+        if (slot.pickupDelay >= 0) {
+            stageLatencies.pickup.record(slot.pickupDelay);
+        }
+    }
+}
+
+// Open-loop run of the threaded bakery: the main thread injects orders at their arrival times
+// whether or not the bakers keep up. Each order is stamped with its scheduled arrival, so time
+// spent blocked on a full order queue under overload still counts towards its latency.
+long long runLoad(const vector<long long>& arrivals, int numBakers) {
+    vector<pthread_t> bakers(numBakers);
+    vector<int> bakerIds(numBakers);
+    long long bakeryStart = getCurrentTimeMicros();
+    for (int i = 0; i < numBakers; ++i) {
+        bakerIds[i] = i;
+        pthread_create(&bakers[i], nullptr, bakerThread, &bakerIds[i]);
+    }
+    for (size_t i = 0; i < arrivals.size(); ++i) {
+        long long due = bakeryStart + arrivals[i];
+        long long wait = due - getCurrentTimeMicros();
+        if (wait > 0) {
+            usleep(wait);
+        }
+        orderQueue.push({(int)i, orderSlots[i].needed, due});
+    }
+    orderQueue.close();
+    for (int i = 0; i < numBakers; ++i) {
+        pthread_join(bakers[i], nullptr);
+    }
+    return bakeryStart;
+}
+
+// Task mode: customers and bakers are coroutines on a pool with one worker per core. Waiting for
+// an order, for the oven or for a batch to bake suspends the task instead of blocking a thread.
+Task bakerTask(TaskPool& pool, AsyncQueue<OrderRecord>& orders, AsyncOven& taskOven, int bakerId) {
+    StageLatencies latencies;
+    while (optional<OrderRecord> next = co_await orders.pop()) {
+        OrderRecord order = *next;
+        latencies.queueWait.record(getCurrentTimeMicros() - order.timestamp);
+        int customerId = order.customerId;
+        const string& customerName = customerNames[customerId];
+        OrderSlot& slot = orderSlots[customerId];
+        LOG_INFO("Baker %d is preparing order for %s with %d breads.", bakerId + 1, customerName.c_str(), order.breads);
+        long long deadline = orderDeadline(order.timestamp, order.breads);
+        int remainingBreads = order.breads;
+        while (remainingBreads > 0) {
+            long long requested = getCurrentTimeMicros();
+            int batchToBake = co_await taskOven.acquire(remainingBreads, remainingBreads, deadline, requested);
+            long long baked = getCurrentTimeMicros();
+            latencies.ovenWait.record(baked - requested);
+            LOG_INFO("Baker %d is baking %d breads for %s.", bakerId + 1, batchToBake, customerName.c_str());
+            co_await pool.sleepFor(BREAD_BAKING_TIME);
+            long long ready = getCurrentTimeMicros();
+            latencies.baking.record(ready - baked);
+            slot.delivered.fetch_add(batchToBake, memory_order_relaxed);
+            if (batchToBake == remainingBreads) {
+                slot.readyTime = ready;
+                slot.ready.set(pool);
+            }
+            taskOven.release(batchToBake, getCurrentTimeMicros());
+            remainingBreads -= batchToBake;
+        }
+        double duration = static_cast<double>(computeDurationMicros(order.timestamp, getCurrentTimeMicros())) / 1000000.0;
+        {
+            lock_guard<mutex> tLock(timeMutex);
+            orderDurations.push_back(duration);
+        }
+        LOG_INFO("Baker %d has completed order for %s.", bakerId + 1, customerName.c_str());
+    }
+    lock_guard<mutex> tLock(timeMutex);
+    stageLatencies.merge(latencies);
+}
+
+Task customerTask(AsyncQueue<OrderRecord>& orders, atomic<int>& customersLeft, int customerId) {
+    const string& customerName = customerNames[customerId];
+    OrderSlot& slot = orderSlots[customerId];
+    orders.push({customerId, slot.needed, getCurrentTimeMicros()});
+    LOG_INFO("Customer %s has signaled their order.", customerName.c_str());
+    if (customersLeft.fetch_sub(1) == 1) {
+        orders.close();
+    }
+    if (slot.needed > 0) {
+        co_await slot.ready;
+        slot.pickupDelay = getCurrentTimeMicros() - slot.readyTime;
+    }
+    LOG_INFO("Customer %s has picked up their order.", customerName.c_str());
+}
+
+// Open-loop order source for task mode, stamping orders like runLoad does.
+Task generatorTask(TaskPool& pool, AsyncQueue<OrderRecord>& orders, const vector<long long>& arrivals, long long start) {
+    for (size_t i = 0; i < arrivals.size(); ++i) {
+        long long due = start + arrivals[i];
+        co_await pool.sleepFor(due - getCurrentTimeMicros());
+        orders.push({(int)i, orderSlots[i].needed, due});
+    }
+    orders.close();
+}
+
+// With `arrivals`, orders come from an open-loop generator instead of customer tasks.
+long long runTasks(int numCustomers, int numBakers, OvenPolicy policy, bool packing, const vector<long long>* arrivals) {
+    TaskPool pool;
+    AsyncQueue<OrderRecord> orders(pool);
+    AsyncOven taskOven(pool, ovenCapacity, policy, packing);
+    atomic<int> customersLeft{numCustomers};
+    long long bakeryStart = getCurrentTimeMicros();
+    for (int i = 0; i < numBakers; ++i) {
+        pool.spawn(bakerTask(pool, orders, taskOven, i));
+    }
+    if (arrivals) {
+        pool.spawn(generatorTask(pool, orders, *arrivals, bakeryStart));
+    } else {
+        for (int i = 0; i < numCustomers; ++i) {
+            pool.spawn(customerTask(orders, customersLeft, i));
+        }
+        if (numCustomers == 0) {
+            orders.close();
+        }
+    }
+    pool.waitIdle();
+    long long makespan = getCurrentTimeMicros() - bakeryStart;
+    mergePickupDelays();
+    asynclog::flush();
+    cout << "All orders are complete.\n";
+    printStatistics(orderDurations);
+    stageLatencies.print(cout);
+    cout << "Oven policy: " << ovenPolicyName(policy) << (packing ? " with packing" : "") << "\n";
+    cout << "Oven utilization: " << 100.0 * taskOven.utilization(bakeryStart, getCurrentTimeMicros()) << "%\n";
+    cout << "Worker threads: " << pool.workerCount() << "\n";
+    return makespan;
+}
+
+// Usage: ./chaos [fifo|sjf|edf] [--pack] [--tasks | --simulate | --simulate-random <customers> <bakers> [seed]
+//                                        | --sweep <customers> <maxBakers> [seed]]
+//                [--orders <file> [--bakers <n>] [--arrival burst|fixed:<rate>|poisson:<rate>|replay] [--seed <n>]]
+//   --tasks            runs customers and bakers as coroutines on a worker pool instead of one thread each
+//   --orders           reads "<name> <breads> [arrival_us]" lines from a file instead of the prompts and
+//                      injects them open-loop by the arrival process (default burst: all at once)
+//   --simulate         reads the usual input and runs it on a virtual clock instead of real threads
+//   --simulate-random  simulates random orders of 1..15 breads with 10 breads of oven per baker
+//   --sweep            simulates one random workload across baker counts and oven sizes
+int main(int argc, char* argv[]) {
     int numCustomers, numBakers;
-    vector<string> customerNames;
-    
-    getInput(numCustomers, numBakers, customerNames, customerOrders);
+    OvenPolicy policy = OvenPolicy::Fifo;
+    bool packing = false;
+    string mode;
+    vector<long long> modeArgs;
+    string orderFile;
+    ArrivalProcess arrival;
+    int loadBakers = 1;
+    unsigned loadSeed = 1;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--pack") {
+            packing = true;
+        } else if ((arg == "--orders" || arg == "--arrival" || arg == "--bakers" || arg == "--seed") && i + 1 < argc) {
+            string value = argv[++i];
+            if (arg == "--orders") {
+                orderFile = value;
+            } else if (arg == "--bakers") {
+                loadBakers = max(1, atoi(value.c_str()));
+            } else if (arg == "--seed") {
+                loadSeed = (unsigned)atoll(value.c_str());
+            } else if (!parseArrivalProcess(value, arrival)) {
+                cerr << "Unknown arrival process " << value << " (expected burst, fixed:<rate>, poisson:<rate> or replay)\n";
+                return 1;
+            }
+        } else if (arg == "--tasks" || arg == "--simulate" || arg == "--simulate-random" || arg == "--sweep") {
+            mode = arg;
+            while (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) {
+                modeArgs.push_back(atoll(argv[++i]));
+            }
+        } else if (!parseOvenPolicy(arg, policy)) {
+            cerr << "Unknown oven policy " << arg << " (expected fifo, sjf or edf)\n";
+            return 1;
+        }
+    }
+    if ((mode == "--simulate-random" || mode == "--sweep") && (modeArgs.size() < 2 || modeArgs[1] < 1)) {
+        cerr << "Usage: ./chaos " << mode << " <customers> <bakers> [seed]\n";
+        return 1;
+    }
+    unsigned seed = modeArgs.size() > 2 ? (unsigned)modeArgs[2] : 1;
+    if (mode == "--simulate-random") {
+        vector<int> orders = randomOrders(modeArgs[0], seed);
+        printSimulation(simulateBakery(orders, {}, modeArgs[1], 10 * modeArgs[1], policy, packing), policy, packing);
+        return 0;
+    }
+    if (mode == "--sweep") {
+        runSweep(modeArgs[0], modeArgs[1], seed, policy, packing);
+        return 0;
+    }
+
+    if (orderFile.empty() && arrival.kind != ArrivalKind::Burst) {
+        cerr << "--arrival needs an order file (--orders)\n";
+        return 1;
+    }
+    vector<long long> arrivals;
+    if (!orderFile.empty()) {
+        vector<LoadedOrder> loaded;
+        string error;
+        if (!loadOrderFile(orderFile, loaded, error) || !arrivalTimes(loaded, arrival, loadSeed, arrivals, error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        numCustomers = loaded.size();
+        numBakers = loadBakers;
+        for (const LoadedOrder& order : loaded) {
+            if (order.breads > MAX_BREADS_PER_CUSTOMER) {
+                cerr << "Maximum bread order is " << MAX_BREADS_PER_CUSTOMER << " (" << order.name << " ordered "
+                     << order.breads << ")\n";
+                return 1;
+            }
+            customerNames.push_back(order.name);
+            customerBreads.push_back(order.breads);
+        }
+    } else {
+        getInput(numCustomers, numBakers, customerNames, customerBreads);
+    }
+    if (mode == "--simulate") {
+        SimulationResult result = simulateBakery(customerBreads, arrivals, numBakers, 10 * numBakers, policy, packing);
+        printSimulation(result, policy, packing);
+        if (!orderFile.empty()) {
+            printLoad(customerBreads, arrivals, arrival, result.makespan, 10 * numBakers);
+        }
+        return 0;
+    }
     ovenCapacity = 10 * numBakers;
+    orderSlots = vector<OrderSlot>(numCustomers);
+    for (int i = 0; i < numCustomers; ++i) {
+        orderSlots[i].needed = customerBreads[i];
+    }
+    if (mode == "--tasks") {
+        long long makespan = runTasks(numCustomers, numBakers, policy, packing, orderFile.empty() ? nullptr : &arrivals);
+        if (!orderFile.empty()) {
+            printLoad(customerBreads, arrivals, arrival, makespan, ovenCapacity);
+        }
+        return 0;
+    }
+    // Task mode brings its own AsyncOven; the threaded paths below share this one.
+    oven = make_unique<OvenManager>(ovenCapacity, policy, packing);
+    if (!orderFile.empty()) {
+        long long bakeryStart = runLoad(arrivals, numBakers);
+        long long bakeryEnd = getCurrentTimeMicros();
+        asynclog::flush();
+        cout << "All orders are complete.\n";
+        printStatistics(orderDurations);
+        stageLatencies.print(cout);
+        cout << "Oven policy: " << ovenPolicyName(policy) << (packing ? " with packing" : "") << "\n";
+        cout << "Oven utilization: " << 100.0 * oven->utilization(bakeryStart, bakeryEnd) << "%\n";
+        printLoad(customerBreads, arrivals, arrival, bakeryEnd - bakeryStart, ovenCapacity);
+        return 0;
+    }
 
     vector<pthread_t> customers(numCustomers);
     vector<pthread_t> bakers(numBakers);
     vector<int> bakerIds(numBakers);
+    vector<int> customerIds(numCustomers);
 
+    long long bakeryStart = getCurrentTimeMicros();
     for (int i = 0; i < numCustomers; ++i) {
-        pthread_create(&customers[i], nullptr, customerThread, &customerNames[i]);
+        customerIds[i] = i;
+        pthread_create(&customers[i], nullptr, customerThread, &customerIds[i]);
     }
     for (int i = 0; i < numBakers; ++i) {
         bakerIds[i] = i;
@@ -202,15 +610,16 @@ int main() {
     for (int i = 0; i < numCustomers; ++i) {
         pthread_join(customers[i], nullptr);
     }
-    {
-        lock_guard<mutex> lock(signalMutex);
-        bakeryOpen = false;
-    }
-    signalCV.notify_all();
+    orderQueue.close();
     for (int i = 0; i < numBakers; ++i) {
         pthread_join(bakers[i], nullptr);
     }
+    mergePickupDelays();
+    asynclog::flush();
     cout << "All orders are complete.\n";
     printStatistics(orderDurations);
+    stageLatencies.print(cout);
+    cout << "Oven policy: " << ovenPolicyName(policy) << (packing ? " with packing" : "") << "\n";
+    cout << "Oven utilization: " << 100.0 * oven->utilization(bakeryStart, getCurrentTimeMicros()) << "%\n";
     return 0;
 }
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+// Log-bucketed latency histogram in the style of HdrHistogram, over microseconds. Values below
+// SUB_COUNT get exact buckets; above that every power of two is split into SUB_COUNT / 2 linear
+// sub-buckets, so any value is reported within 1 / 64 of itself. Recording is a shift and an
+// increment with no locking: each thread keeps its own histograms and merges them at shutdown.
+// The bucket array only grows to the largest index touched, so short waits cost a few hundred bytes.
+class LatencyHistogram {
+public:
+    void record(long long micros) {
+        uint64_t value = micros > 0 ? (uint64_t)micros : 0;
+        size_t index = bucketIndex(value);
+        if (index >= counts.size()) counts.resize(index + 1, 0);
+        counts[index]++;
+        total++;
+        maxValue = std::max(maxValue, value);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        if (other.counts.size() > counts.size()) counts.resize(other.counts.size(), 0);
+        for (size_t i = 0; i < other.counts.size(); ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return maxValue; }
+
+    // Smallest recorded value v such that `fraction` of the samples are <= v, reported as the
+    // upper end of its bucket (never above the true maximum).
+    uint64_t percentile(double fraction) const {
+        if (total == 0) return 0;
+        uint64_t rank = std::max<uint64_t>(1, (uint64_t)(fraction * total + 0.999999));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(bucketUpperBound(i), maxValue);
+        }
+        return maxValue;
+    }
+
+private:
+    static constexpr int SUB_BITS = 7;
+    static constexpr uint64_t SUB_COUNT = 1 << SUB_BITS;
+    static constexpr uint64_t HALF_COUNT = SUB_COUNT / 2;
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < SUB_COUNT) return value;
+        int shift = (63 - std::countl_zero(value)) - SUB_BITS + 1;
+        return shift * HALF_COUNT + (value >> shift);
+    }
+
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < SUB_COUNT) return index;
+        int shift = index / HALF_COUNT - 1;
+        uint64_t top = index - shift * HALF_COUNT;
+        return ((top + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t maxValue = 0;
+};
+
+// The four stages an order goes through: waiting for a baker, waiting for oven space (per batch),
+// in the oven (per batch), and finished but not yet picked up by the customer.
+struct StageLatencies {
+    LatencyHistogram queueWait;
+    LatencyHistogram ovenWait;
+    LatencyHistogram baking;
+    LatencyHistogram pickup;
+
+    void merge(const StageLatencies& other) {
+        queueWait.merge(other.queueWait);
+        ovenWait.merge(other.ovenWait);
+        baking.merge(other.baking);
+        pickup.merge(other.pickup);
+    }
+
+    void print(std::ostream& out) const {
+        out << "\n---Stage latencies (ms)---\n";
+        out << std::left << std::setw(12) << "stage" << std::right << std::setw(9) << "count"
+            << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+            << std::setw(10) << "p99.9" << std::setw(10) << "max" << "\n";
+        printRow(out, "queue wait", queueWait);
+        printRow(out, "oven wait", ovenWait);
+        printRow(out, "baking", baking);
+        printRow(out, "pickup", pickup);
+    }
+
+private:
+    static void printRow(std::ostream& out, const char* name, const LatencyHistogram& histogram) {
+        out << std::left << std::setw(12) << name << std::right << std::setw(9) << histogram.count()
+            << std::fixed << std::setprecision(2);
+        for (double fraction : { 0.50, 0.90, 0.99, 0.999 }) {
+            out << std::setw(10) << histogram.percentile(fraction) / 1000.0;
+        }
+        out << std::setw(10) << histogram.max() / 1000.0 << "\n";
+    }
+};
@@ -1,46 +1,67 @@
 #include <iostream>
-#include <queue>
 #include <string>
 #include <vector>
 #include <utility>
 #include <pthread.h>
 #include <unistd.h>
 #include <mutex>
-#include <condition_variable>
+#include <thread>
 #include <cmath>
 #include <sstream>
 #include <cctype>
 #include <algorithm>
 #include <chrono>
 #include <map>
+#include <memory>
+#include <random>
+#include <atomic>
+#include <functional>
+#include "work_stealing_deque.hpp"
+#include "bakery_sim.hpp"
+#include "spsc_ring.hpp"
+#include "latency_histogram.hpp"
+#include "async_log.hpp"
 
 using namespace std;
 
 const int BREAD_BAKING_TIME = 2000000;
 
-vector<queue<pair<string, int>>> bakerQueues;
-vector<pair<string, int>> sharedBreadStorage;
-mutex storageMutex;
-mutex queueMutex;
-condition_variable bakerCV;
-condition_variable customerCV;
-bool allOrdersCompleted = false;
+// Customer names are interned into dense ids at input; everything after that indexes by id.
+struct Order {
+    int customer;
+    int breads;
+    chrono::steady_clock::time_point placedAt;
+};
+
+// A batch out of the oven, handed from its baker to the collector. The order's last batch is
+// marked orderDone; its readyAt is the order's completion time.
+struct CompletedBatch {
+    int order;
+    int breads;
+    bool orderDone;
+    chrono::steady_clock::time_point readyAt;
+};
+
+const size_t BATCH_RING_CAPACITY = 256;
+
+vector<string> customerNames;
+vector<Order> orders;
+vector<unique_ptr<WorkStealingDeque>> bakerQueues;
+bool workStealing = true;
+
+vector<unique_ptr<SpscRing<CompletedBatch>>> completedBatches;
+atomic<uint32_t> batchEvents{0};
+atomic<int> outstandingOrders{0};
+mutex statsMutex;
 int ovenCapacity;
 int currentOvenUsage = 0;
 pthread_mutex_t ovenMutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t ovenCond = PTHREAD_COND_INITIALIZER;
-map<string, queue<chrono::steady_clock::time_point>> orderStartTimes;
 vector<double> deliveryTimes;
-map<string, int> customerOrderCounts;
+StageLatencies stageLatencies;  // guarded by statsMutex
 
-void trim(string& str) {
-    size_t start = str.find_first_not_of(" ");
-    size_t end = str.find_last_not_of(" ");
-    if (start == string::npos || end == string::npos) {
-        str = "";
-    } else {
-        str = str.substr(start, end - start + 1);
-    }
+long long microsBetween(chrono::steady_clock::time_point start, chrono::steady_clock::time_point end) {
+    return chrono::duration_cast<chrono::microseconds>(end - start).count();
 }
 
 bool isValidNumber(const string& str) {
@@ -80,95 +101,120 @@ void printStatistics(const vector<double>& deliveryTimes) {
     cout << "Standard deviation: " << stdDev << "\n";
 }
 
-void recordOrderStart(const string& customerName) {
-    orderStartTimes[customerName].push(chrono::steady_clock::now());
+// Splits a line on spaces in one pass, skipping empty words.
+vector<string> splitWords(const string& line) {
+    vector<string> words;
+    size_t start = line.find_first_not_of(' ');
+    while (start != string::npos) {
+        size_t end = line.find(' ', start);
+        words.push_back(line.substr(start, end - start));
+        start = line.find_first_not_of(' ', end);
+    }
+    return words;
 }
 
 void getInput() {
+    map<string, int> customerIds;
     int numBakers;
     cin >> numBakers;
     cin.ignore();
-    bakerQueues.resize(numBakers);
+    vector<vector<int>> assigned(numBakers);
     ovenCapacity = 10 * numBakers;
     for (int i = 0; i < numBakers; ++i) {
         string line;
         getline(cin, line);
-        trim(line);
-        vector<string> names;
-        size_t pos = 0;
-        while ((pos = line.find(' ')) != string::npos) {
-            string name = line.substr(0, pos);
-            trim(name);
-            if (!name.empty()) {
-                names.push_back(name);
-            }
-            line.erase(0, pos + 1);
-        }
-        trim(line);
-        if (!line.empty()) {
-            names.push_back(line);
-        }
+        vector<string> names = splitWords(line);
         getline(cin, line);
-        trim(line);
         vector<int> counts;
-        pos = 0;
-        while ((pos = line.find(' ')) != string::npos) {
-            string countStr = line.substr(0, pos);
-            trim(countStr);
+        for (const string& countStr : splitWords(line)) {
             if (isValidNumber(countStr)) {
                 counts.push_back(stoi(countStr));
             } else {
                 return;
             }
-            line.erase(0, pos + 1);
-        }
-        trim(line);
-        if (!line.empty()) {
-            if (isValidNumber(line)) {
-                counts.push_back(stoi(line));
-            } else {
-                return;
-            }
         }
         if (names.size() == counts.size()) {
             for (size_t j = 0; j < names.size(); ++j) {
-                bakerQueues[i].push({names[j], counts[j]});
-                recordOrderStart(names[j]);
-                if (customerOrderCounts.find(names[j]) == customerOrderCounts.end()) {
-                    customerOrderCounts[names[j]] = counts[j];
-                } else {
-                    customerOrderCounts[names[j]] += counts[j];
+                auto id = customerIds.emplace(names[j], (int)customerNames.size());
+                if (id.second) {
+                    customerNames.push_back(names[j]);
                 }
+                assigned[i].push_back(orders.size());
+                orders.push_back({ id.first->second, counts[j], chrono::steady_clock::now() });
             }
         }
     }
+    // The owner pops from the bottom, so push each line in reverse: the baker still bakes its orders
+    // in input order and thieves take the end of the line.
+    for (int i = 0; i < numBakers; ++i) {
+        bakerQueues.push_back(make_unique<WorkStealingDeque>(assigned[i].size()));
+        for (auto it = assigned[i].rbegin(); it != assigned[i].rend(); ++it) {
+            bakerQueues[i]->push(*it);
+        }
+    }
 }
 
-void* bakerThread(void* arg) {
-    int bakerId = *(int*)arg;
+// A baker takes from its own deque first; with stealing enabled it then tries the other bakers
+// starting from a random victim, and only gives up once every deque has been seen empty.
+bool takeOrder(int bakerId, mt19937& rng, int& order) {
+    if (bakerQueues[bakerId]->pop(order)) {
+        return true;
+    }
+    if (!workStealing) {
+        return false;
+    }
+    int numBakers = bakerQueues.size();
     while (true) {
-        pair<string, int> order;
-        {
-            unique_lock<mutex> lock(queueMutex);
-            bakerCV.wait(lock, [&]() {
-                return !bakerQueues[bakerId].empty() || allOrdersCompleted;
-            });
-            if (allOrdersCompleted) {
-                break;
+        bool contended = false;
+        int start = uniform_int_distribution<int>(0, numBakers - 1)(rng);
+        for (int k = 0; k < numBakers; ++k) {
+            int victim = (start + k) % numBakers;
+            if (victim == bakerId) {
+                continue;
             }
-            if (!bakerQueues[bakerId].empty()) {
-                order = bakerQueues[bakerId].front();
-                bakerQueues[bakerId].pop();
+            auto result = bakerQueues[victim]->steal(order);
+            if (result == WorkStealingDeque::StealResult::Success) {
+                return true;
+            }
+            if (result == WorkStealingDeque::StealResult::Abort) {
+                contended = true;
             }
         }
-        if (order.first.empty()) {
-            continue;
+        if (!contended) {
+            return false;
         }
-        cout << "Baker " << bakerId + 1 << " is preparing order for: " << order.first << "\n";
-        int remainingBreads = order.second;
+    }
+}
+
+// Hands a batch to the collector through this baker's ring and bumps the event counter it sleeps
+// on. A finished order is counted off only after its last batch is in the ring, so the collector
+// sees every batch before it sees the count reach zero.
+void publishBatch(int bakerId, const CompletedBatch& batch) {
+    while (!completedBatches[bakerId]->tryPush(batch)) {
+        this_thread::yield();
+    }
+    if (batch.orderDone) {
+        outstandingOrders.fetch_sub(1, memory_order_release);
+    }
+    batchEvents.fetch_add(1);
+    batchEvents.notify_one();
+}
+
+void* bakerThread(void* arg) {
+    int bakerId = *(int*)arg;
+    mt19937 rng(bakerId + 1);
+    int orderIndex;
+    StageLatencies latencies;
+    while (takeOrder(bakerId, rng, orderIndex)) {
+        const Order& order = orders[orderIndex];
+        const string& customerName = customerNames[order.customer];
+        latencies.queueWait.record(microsBetween(order.placedAt, chrono::steady_clock::now()));
+        LOG_INFO("Baker %d is preparing order for: %s", bakerId + 1, customerName.c_str());
+        int remainingBreads = order.breads;
         int batch = 1;
         while (remainingBreads > 0) {
             int breadsToBake = min(remainingBreads, ovenCapacity - currentOvenUsage);
+            auto requested = chrono::steady_clock::now();
             {
                 pthread_mutex_lock(&ovenMutex);
                 while (currentOvenUsage + breadsToBake > ovenCapacity) {
@@ -177,92 +223,143 @@ void* bakerThread(void* arg) {
                 currentOvenUsage += breadsToBake;
                 pthread_mutex_unlock(&ovenMutex);
             }
-            cout << "Baker " << bakerId + 1 << " is baking batch " << batch
-                      << " (" << breadsToBake << " breads) for " << order.first << "\n";
+            auto baked = chrono::steady_clock::now();
+            latencies.ovenWait.record(microsBetween(requested, baked));
+            LOG_INFO("Baker %d is baking batch %d (%d breads) for %s", bakerId + 1, batch, breadsToBake, customerName.c_str());
             usleep(BREAD_BAKING_TIME);
+            auto ready = chrono::steady_clock::now();
+            latencies.baking.record(microsBetween(baked, ready));
             {
                 pthread_mutex_lock(&ovenMutex);
                 currentOvenUsage -= breadsToBake;
                 pthread_cond_broadcast(&ovenCond);
                 pthread_mutex_unlock(&ovenMutex);
             }
-            {
-                lock_guard<mutex> lock(storageMutex);
-                for (int i = 1; i <= breadsToBake; ++i) {
-                    sharedBreadStorage.push_back(
-                        make_pair(order.first, order.second - remainingBreads + i)
-                    );
-                }
-            }
+            publishBatch(bakerId, { orderIndex, breadsToBake, breadsToBake == remainingBreads, ready });
             remainingBreads -= breadsToBake;
             ++batch;
             if (remainingBreads > 0) {
-                cout << "Oven can now process the remaining " 
-                          << remainingBreads << " breads for " << order.first << ".\n";
+                LOG_INFO("Oven can now process the remaining %d breads for %s.", remainingBreads, customerName.c_str());
             }
         }
-        cout << "Baker " << bakerId + 1 << " completed order for: " << order.first << "\n";
-        customerCV.notify_all();
+        if (order.breads <= 0) {
+            publishBatch(bakerId, { orderIndex, 0, true, chrono::steady_clock::now() });
+        }
+        LOG_INFO("Baker %d completed order for: %s", bakerId + 1, customerName.c_str());
     }
+    lock_guard<mutex> lock(statsMutex);
+    stageLatencies.merge(latencies);
     return nullptr;
 }
 
-void* queueThread(void* arg) {
-    int numBakers = *(int*)arg;
+// The collector drains every baker's ring, O(1) per batch, and sleeps on the event counter when
+// they are all empty. It stops once no order is outstanding and the rings have been drained.
+void* queueThread(void*) {
+    LatencyHistogram pickup;
     while (true) {
-        {
-            lock_guard<mutex> lock(queueMutex);
-            bool allEmpty = true;
-            for (const auto& q : bakerQueues) {
-                if (!q.empty()) {
-                    allEmpty = false;
-                    break;
-                }
-            }
-            {
-                lock_guard<mutex> lock(storageMutex);
-                if (allEmpty && sharedBreadStorage.empty()) {
-                    allOrdersCompleted = true;
-                    bakerCV.notify_all();
-                    break;
+        uint32_t seen = batchEvents.load();
+        bool finished = outstandingOrders.load(memory_order_acquire) == 0;
+        bool collected = false;
+        for (auto& ring : completedBatches) {
+            CompletedBatch batch;
+            while (ring->tryPop(batch)) {
+                collected = true;
+                const Order& order = orders[batch.order];
+                pickup.record(microsBetween(batch.readyAt, chrono::steady_clock::now()));
+                if (batch.orderDone) {
+                    deliveryTimes.push_back(chrono::duration_cast<chrono::milliseconds>(batch.readyAt - order.placedAt).count());
                 }
             }
         }
-        {
-            unique_lock<mutex> lock(storageMutex);
-            customerCV.wait(lock, [&]() { return !sharedBreadStorage.empty(); });
-            for (auto it = sharedBreadStorage.begin(); it != sharedBreadStorage.end();) {
-                const string& customerName = it->first;
-                if (!orderStartTimes[customerName].empty()) {
-                    auto start = orderStartTimes[customerName].front();
-                    orderStartTimes[customerName].pop();
-                    auto end = chrono::steady_clock::now();
-                    double diffMs = chrono::duration_cast<chrono::milliseconds>(end - start).count();
-                    deliveryTimes.push_back(diffMs);
-                }
-                if (customerOrderCounts.find(customerName) != customerOrderCounts.end()) {
-                    customerOrderCounts[customerName]--;
-                    if (customerOrderCounts[customerName] == 0) {
-                        //cout << customerName << " has collected their full order.\n";
-                        customerOrderCounts.erase(customerName);
-                    }
-                }
-                it = sharedBreadStorage.erase(it);
-            }
+        if (finished) {
+            break;
+        }
+        if (!collected) {
+            batchEvents.wait(seen);
         }
-        bakerCV.notify_all();
     }
-    bakerCV.notify_all();
+    lock_guard<mutex> lock(statsMutex);
+    stageLatencies.pickup.merge(pickup);
     return nullptr;
 }
 
-int main() {
+// The threaded bakery on a virtual clock: bakers take orders through the same takeOrder and size
+// batches by the same free-oven rule, and an order's delivery time is taken when its last batch
+// comes out of the oven, so the statistics follow the real-time run.
+long long simulateBakery() {
+    EventLoop loop;
+    int numBakers = bakerQueues.size();
+    vector<mt19937> rngs;
+    for (int i = 0; i < numBakers; ++i) {
+        rngs.emplace_back(i + 1);
+    }
+    vector<int> currentOrder(numBakers), remainingBreads(numBakers);
+    function<void(int)> startOrder;
+    function<void(int)> bakeBatch = [&](int bakerId) {
+        if (remainingBreads[bakerId] <= 0) {
+            startOrder(bakerId);
+            return;
+        }
+        int breadsToBake = min(remainingBreads[bakerId], ovenCapacity - currentOvenUsage);
+        currentOvenUsage += breadsToBake;
+        loop.after(BREAD_BAKING_TIME, [&, bakerId, breadsToBake]() {
+            currentOvenUsage -= breadsToBake;
+            remainingBreads[bakerId] -= breadsToBake;
+            if (remainingBreads[bakerId] <= 0) {
+                deliveryTimes.push_back(loop.now() / 1000);
+            }
+            bakeBatch(bakerId);
+        });
+    };
+    startOrder = [&](int bakerId) {
+        int orderIndex;
+        if (!takeOrder(bakerId, rngs[bakerId], orderIndex)) {
+            return;
+        }
+        currentOrder[bakerId] = orderIndex;
+        remainingBreads[bakerId] = orders[orderIndex].breads;
+        if (remainingBreads[bakerId] <= 0) {
+            deliveryTimes.push_back(loop.now() / 1000);
+        }
+        bakeBatch(bakerId);
+    };
+    for (int i = 0; i < numBakers; ++i) {
+        loop.at(0, [&, i]() { startOrder(i); });
+    }
+    loop.run();
+    return loop.now() / 1000;
+}
+
+// Usage: ./multi [--static] [--simulate]
+//   --static    disables work stealing: each baker only bakes its own line
+//   --simulate  runs the schedule on a virtual clock instead of sleeping threads
+int main(int argc, char* argv[]) {
+    bool simulate = false;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--static") {
+            workStealing = false;
+        } else if (string(argv[i]) == "--simulate") {
+            simulate = true;
+        }
+    }
     getInput();
+    if (simulate) {
+        long long makespan = simulateBakery();
+        printStatistics(deliveryTimes);
+        cout << "Scheduling: " << (workStealing ? "work stealing" : "static") << " (simulated)\n";
+        cout << "Makespan: " << makespan << " ms\n";
+        return 0;
+    }
     int numBakers = bakerQueues.size();
     vector<pthread_t> bakers(numBakers);
     vector<int> bakerIds(numBakers);
     pthread_t queueManager;
-    pthread_create(&queueManager, nullptr, queueThread, &numBakers);
+    for (int i = 0; i < numBakers; ++i) {
+        completedBatches.push_back(make_unique<SpscRing<CompletedBatch>>(BATCH_RING_CAPACITY));
+    }
+    outstandingOrders.store(orders.size());
+    auto start = chrono::steady_clock::now();
+    pthread_create(&queueManager, nullptr, queueThread, nullptr);
     for (int i = 0; i < numBakers; ++i) {
         bakerIds[i] = i;
         pthread_create(&bakers[i], nullptr, bakerThread, &bakerIds[i]);
@@ -270,7 +367,12 @@ int main() {
     for (int i = 0; i < numBakers; ++i) {
         pthread_join(bakers[i], nullptr);
     }
+    auto end = chrono::steady_clock::now();
     pthread_join(queueManager, nullptr);
+    asynclog::flush();
     printStatistics(deliveryTimes);
+    stageLatencies.print(cout);
+    cout << "Scheduling: " << (workStealing ? "work stealing" : "static") << "\n";
+    cout << "Makespan: " << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms\n";
     return 0;
 }
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// One line of an order file: "<name> <breads> [arrival_us]". Blank lines and lines starting with
+// '#' are skipped. arrival is -1 when the line has no timestamp.
+struct LoadedOrder {
+    std::string name;
+    int breads;
+    long long arrival;
+};
+
+namespace orderfile {
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) ++p;
+    return p;
+}
+
+template <typename Int>
+inline const char* parseInt(const char* p, const char* end, Int& value) {
+    auto [next, ec] = std::from_chars(p, end, value);
+    return ec == std::errc() ? next : nullptr;
+}
+
+// Parses the whole buffer in one pass; on error names the offending line.
+inline bool parse(const char* p, const char* end, std::vector<LoadedOrder>& orders, std::string& error) {
+    size_t line = 0;
+    while (p < end) {
+        ++line;
+        p = skipBlanks(p, end);
+        if (p == end) break;
+        if (*p == '\n' || *p == '#') {
+            while (p < end && *p != '\n') ++p;
+            ++p;
+            continue;
+        }
+        const char* nameStart = p;
+        while (p < end && !isBlank(*p) && *p != '\n') ++p;
+        LoadedOrder order{ std::string(nameStart, p), 0, -1 };
+        p = skipBlanks(p, end);
+        if (p == end || !(p = parseInt(p, end, order.breads)) || order.breads < 0) {
+            error = "line " + std::to_string(line) + ": expected a bread count after the name";
+            return false;
+        }
+        p = skipBlanks(p, end);
+        if (p < end && *p != '\n') {
+            if (!(p = parseInt(p, end, order.arrival)) || order.arrival < 0) {
+                error = "line " + std::to_string(line) + ": bad arrival timestamp";
+                return false;
+            }
+            p = skipBlanks(p, end);
+        }
+        if (p < end && *p != '\n') {
+            error = "line " + std::to_string(line) + ": unexpected text after the order";
+            return false;
+        }
+        orders.push_back(std::move(order));
+        ++p;
+    }
+    return true;
+}
+
+} // namespace orderfile
+
+// Maps the file read-only and parses it in place: no per-line reads or copies besides the names.
+inline bool loadOrderFile(const std::string& path, std::vector<LoadedOrder>& orders, std::string& error) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        error = "cannot stat " + path;
+        return false;
+    }
+    if (!S_ISREG(info.st_mode)) {
+        close(fd);
+        error = path + " is not a regular file";
+        return false;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return true;
+    }
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+    const char* begin = static_cast<const char*>(data);
+    orders.reserve(info.st_size / 16);
+    bool ok = orderfile::parse(begin, begin + info.st_size, orders, error);
+    munmap(data, info.st_size);
+    return ok;
+}
+
+// How orders are injected: all at once, at a fixed rate, as a Poisson process, or at the
+// timestamps recorded in the file (relative to the first one).
+enum class ArrivalKind { Burst, Fixed, Poisson, Replay };
+
+struct ArrivalProcess {
+    ArrivalKind kind = ArrivalKind::Burst;
+    double ratePerSecond = 0.0;
+};
+
+// "burst", "fixed:<orders/s>", "poisson:<orders/s>" or "replay".
+inline bool parseArrivalProcess(const std::string& spec, ArrivalProcess& process) {
+    std::string_view view(spec);
+    size_t colon = view.find(':');
+    std::string_view name = view.substr(0, colon);
+    if (name == "burst" || name == "replay") {
+        if (colon != std::string_view::npos) return false;
+        process.kind = name == "burst" ? ArrivalKind::Burst : ArrivalKind::Replay;
+        return true;
+    }
+    if (name != "fixed" && name != "poisson") return false;
+    if (colon == std::string_view::npos) return false;
+    process.kind = name == "fixed" ? ArrivalKind::Fixed : ArrivalKind::Poisson;
+    try {
+        process.ratePerSecond = std::stod(std::string(view.substr(colon + 1)));
+    } catch (...) {
+        return false;
+    }
+    return process.ratePerSecond > 0.0;
+}
+
+inline std::string arrivalProcessName(const ArrivalProcess& process) {
+    switch (process.kind) {
+    case ArrivalKind::Burst: return "burst";
+    case ArrivalKind::Fixed: return "fixed " + std::to_string(process.ratePerSecond) + "/s";
+    case ArrivalKind::Poisson: return "poisson " + std::to_string(process.ratePerSecond) + "/s";
+    case ArrivalKind::Replay: return "replay";
+    }
+    return "?";
+}
+
+// Arrival offset of every order in microseconds from the start of the run, non-decreasing.
+// Replay fails if some order has no timestamp.
+inline bool arrivalTimes(const std::vector<LoadedOrder>& orders, const ArrivalProcess& process, unsigned seed,
+                         std::vector<long long>& times, std::string& error) {
+    times.assign(orders.size(), 0);
+    std::mt19937_64 rng(seed);
+    std::exponential_distribution<double> gap(process.ratePerSecond > 0.0 ? process.ratePerSecond : 1.0);
+    double clock = 0.0;
+    for (size_t i = 0; i < orders.size(); ++i) {
+        switch (process.kind) {
+        case ArrivalKind::Burst:
+            break;
+        case ArrivalKind::Fixed:
+            times[i] = std::llround(i * 1e6 / process.ratePerSecond);
+            break;
+        case ArrivalKind::Poisson:
+            clock += gap(rng) * 1e6;
+            times[i] = std::llround(clock);
+            break;
+        case ArrivalKind::Replay:
+            if (orders[i].arrival < 0) {
+                error = "order " + std::to_string(i + 1) + " (" + orders[i].name + ") has no timestamp to replay";
+                return false;
+            }
+            times[i] = std::max(orders[i].arrival - orders[0].arrival, i > 0 ? times[i - 1] : 0LL);
+            break;
+        }
+    }
+    return true;
+}
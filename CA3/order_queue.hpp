@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Compact order record passed from customers to bakers.
+struct OrderRecord {
+    int customerId;
+    int breads;
+    long long timestamp;
+};
+
+// Bounded lock-free multi-producer/multi-consumer ring (Vyukov's sequence-numbered cells).
+// push/pop spin briefly and then block on an event counter (std::atomic wait, a futex on Linux),
+// so idle consumers do not burn CPU. close() wakes everyone; pop then fails once the ring is empty.
+template <typename T>
+class MPMCQueue {
+public:
+    explicit MPMCQueue(size_t minCapacity) {
+        size_t capacity = 2;
+        while (capacity < minCapacity) capacity <<= 1;
+        mask = capacity - 1;
+        cells.reset(new Cell[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(const T& value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    signal(pushes, waitingConsumers);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T& value) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    signal(pops, waitingProducers);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void push(const T& value) {
+        for (int spin = 0; spin < SPIN_LIMIT; ++spin) {
+            if (tryPush(value)) return;
+            relax(spin);
+        }
+        while (true) {
+            uint32_t seen = pops.load();
+            if (tryPush(value)) return;
+            waitingProducers.fetch_add(1);
+            pops.wait(seen);
+            waitingProducers.fetch_sub(1);
+        }
+    }
+
+    // Returns false only after close() once the queue has been drained.
+    bool pop(T& value) {
+        for (int spin = 0; spin < SPIN_LIMIT; ++spin) {
+            if (tryPop(value)) return true;
+            relax(spin);
+        }
+        while (true) {
+            uint32_t seen = pushes.load();
+            if (tryPop(value)) return true;
+            if (closed.load()) return tryPop(value);
+            waitingConsumers.fetch_add(1);
+            pushes.wait(seen);
+            waitingConsumers.fetch_sub(1);
+        }
+    }
+
+    void close() {
+        closed.store(true);
+        pushes.fetch_add(1);
+        pushes.notify_all();
+    }
+
+private:
+    static constexpr int SPIN_LIMIT = 64;
+
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // Bump the event counter the other side waits on; the seq_cst increment/load pairs with the
+    // waiter's increment/wait so a wake-up is never lost.
+    static void signal(std::atomic<uint32_t>& events, std::atomic<int>& waiters) {
+        events.fetch_add(1);
+        if (waiters.load() > 0) events.notify_one();
+    }
+
+    static void relax(int spin) {
+        if (spin < SPIN_LIMIT / 2) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+    alignas(64) std::atomic<uint32_t> pushes{0};
+    std::atomic<int> waitingConsumers{0};
+    alignas(64) std::atomic<uint32_t> pops{0};
+    std::atomic<int> waitingProducers{0};
+    std::atomic<bool> closed{false};
+};
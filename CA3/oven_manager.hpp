@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class OvenPolicy { Fifo, ShortestJobFirst, EarliestDeadlineFirst };
+
+inline bool parseOvenPolicy(const std::string& name, OvenPolicy& policy) {
+    if (name == "fifo") policy = OvenPolicy::Fifo;
+    else if (name == "sjf") policy = OvenPolicy::ShortestJobFirst;
+    else if (name == "edf") policy = OvenPolicy::EarliestDeadlineFirst;
+    else return false;
+    return true;
+}
+
+inline const char* ovenPolicyName(OvenPolicy policy) {
+    switch (policy) {
+    case OvenPolicy::Fifo: return "fifo";
+    case OvenPolicy::ShortestJobFirst: return "sjf";
+    case OvenPolicy::EarliestDeadlineFirst: return "edf";
+    }
+    return "?";
+}
+
+// One baker's request for oven space. jobSize is the order's remaining breads (SJF key),
+// deadline is in the caller's clock (EDF key); ticket is assigned on submit (FIFO key, tie-break).
+struct OvenRequest {
+    int want = 0;
+    int jobSize = 0;
+    long long deadline = 0;
+    long long ticket = 0;
+    int granted = 0;
+};
+
+// Policy core of the oven, without any locking or clock of its own so the threaded bakery and the
+// simulator share it. Requests are granted strictly in policy order: the head request blocks the
+// ones behind it, so a large batch cannot be starved by a stream of small ones fitting in the gaps.
+// With packing, the head is granted whatever space is free (at least one bread) instead of waiting
+// for its whole batch to fit, so the oven load is topped up with breads from the next orders.
+class OvenAllocator {
+public:
+    OvenAllocator(int capacity, OvenPolicy policy, bool packing)
+        : capacity(capacity), policy(policy), packing(packing) {}
+
+    void submit(OvenRequest* request) {
+        request->ticket = nextTicket++;
+        request->granted = 0;
+        pending.push_back(request);
+    }
+
+    // Grants pending requests while the policy allows; calls onGrant(request) for each one.
+    template <typename OnGrant>
+    void grant(long long now, OnGrant onGrant) {
+        while (!pending.empty()) {
+            auto head = std::min_element(pending.begin(), pending.end(), [this](const OvenRequest* a, const OvenRequest* b) {
+                return before(*a, *b);
+            });
+            OvenRequest* request = *head;
+            int free = capacity - used;
+            int amount = packing ? std::min(request->want, free) : request->want;
+            if (amount <= 0 || amount > free) {
+                break;
+            }
+            pending.erase(head);
+            setUsage(now, used + amount);
+            request->granted = amount;
+            onGrant(request);
+        }
+    }
+
+    void release(long long now, int breads) {
+        setUsage(now, used - breads);
+    }
+
+    // Fraction of oven capacity in use between `start` and `now`.
+    double utilization(long long start, long long now) const {
+        double busy = busyIntegral + (double)used * (now - lastChange);
+        return now > start ? busy / ((double)capacity * (now - start)) : 0.0;
+    }
+
+    int getCapacity() const { return capacity; }
+
+private:
+    bool before(const OvenRequest& a, const OvenRequest& b) const {
+        switch (policy) {
+        case OvenPolicy::ShortestJobFirst:
+            if (a.jobSize != b.jobSize) return a.jobSize < b.jobSize;
+            break;
+        case OvenPolicy::EarliestDeadlineFirst:
+            if (a.deadline != b.deadline) return a.deadline < b.deadline;
+            break;
+        case OvenPolicy::Fifo:
+            break;
+        }
+        return a.ticket < b.ticket;
+    }
+
+    void setUsage(long long now, int newUsage) {
+        busyIntegral += (double)used * (now - lastChange);
+        lastChange = now;
+        used = newUsage;
+    }
+
+    int capacity;
+    OvenPolicy policy;
+    bool packing;
+    int used = 0;
+    long long nextTicket = 0;
+    long long lastChange = 0;
+    double busyIntegral = 0.0;
+    std::vector<OvenRequest*> pending;
+};
+
+// Thread-safe oven for the real-time bakery: acquire blocks until the allocator grants the request.
+class OvenManager {
+public:
+    OvenManager(int capacity, OvenPolicy policy, bool packing) : allocator(capacity, policy, packing) {}
+
+    int acquire(int want, int jobSize, long long deadline, long long now) {
+        OvenRequest request;
+        request.want = std::min(want, allocator.getCapacity());
+        request.jobSize = jobSize;
+        request.deadline = deadline;
+        std::unique_lock<std::mutex> lock(ovenMutex);
+        allocator.submit(&request);
+        bool grantedOthers = false;
+        allocator.grant(now, [&](OvenRequest* r) { grantedOthers |= (r != &request); });
+        if (grantedOthers) ovenCV.notify_all();
+        ovenCV.wait(lock, [&] { return request.granted > 0; });
+        return request.granted;
+    }
+
+    void release(int breads, long long now) {
+        {
+            std::lock_guard<std::mutex> lock(ovenMutex);
+            allocator.release(now, breads);
+            allocator.grant(now, [](OvenRequest*) {});
+        }
+        ovenCV.notify_all();
+    }
+
+    double utilization(long long start, long long now) {
+        std::lock_guard<std::mutex> lock(ovenMutex);
+        return allocator.utilization(start, now);
+    }
+
+private:
+    OvenAllocator allocator;
+    std::mutex ovenMutex;
+    std::condition_variable ovenCV;
+};
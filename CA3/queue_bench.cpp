@@ -0,0 +1,130 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include "order_queue.hpp"
+
+using namespace std;
+
+// The dispatcher as it was in chaos.cpp: a std::queue behind one mutex and condition variables,
+// bounded to the same capacity as the lock-free ring so both apply the same back-pressure.
+template <typename T>
+class MutexQueue {
+public:
+    explicit MutexQueue(size_t capacity) : capacity(capacity) {}
+
+    void push(const T& value) {
+        unique_lock<mutex> lock(queueMutex);
+        notFullCV.wait(lock, [&] { return items.size() < capacity; });
+        items.push(value);
+        lock.unlock();
+        notEmptyCV.notify_one();
+    }
+
+    bool pop(T& value) {
+        unique_lock<mutex> lock(queueMutex);
+        notEmptyCV.wait(lock, [&] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        value = items.front();
+        items.pop();
+        lock.unlock();
+        notFullCV.notify_one();
+        return true;
+    }
+
+    void close() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            closed = true;
+        }
+        notEmptyCV.notify_all();
+    }
+
+private:
+    queue<T> items;
+    size_t capacity;
+    bool closed = false;
+    mutex queueMutex;
+    condition_variable notEmptyCV;
+    condition_variable notFullCV;
+};
+
+long long nowNanos() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct BenchResult {
+    double opsPerSecond;
+    double p50, p99, p999, max;
+};
+
+// `threads` producers and `threads` consumers move `items` order records through the queue;
+// latency is push-to-pop time of each record in microseconds.
+template <typename Queue>
+BenchResult runBench(int threads, int items, size_t capacity) {
+    Queue queue(capacity);
+    vector<vector<long long>> latencies(threads);
+    vector<thread> producers, consumers;
+    long long start = nowNanos();
+    for (int c = 0; c < threads; ++c) {
+        consumers.emplace_back([&, c] {
+            OrderRecord order;
+            latencies[c].reserve(items / threads + 1);
+            while (queue.pop(order)) {
+                latencies[c].push_back(nowNanos() - order.timestamp);
+            }
+        });
+    }
+    for (int p = 0; p < threads; ++p) {
+        producers.emplace_back([&, p] {
+            int begin = (long long)items * p / threads;
+            int end = (long long)items * (p + 1) / threads;
+            for (int i = begin; i < end; ++i) {
+                queue.push({i, 1 + i % 15, nowNanos()});
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    queue.close();
+    for (auto& t : consumers) t.join();
+    long long end = nowNanos();
+
+    vector<long long> all;
+    all.reserve(items);
+    for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    sort(all.begin(), all.end());
+    auto percentile = [&](double q) {
+        return all[min(all.size() - 1, (size_t)(q * all.size()))] / 1000.0;
+    };
+    return {items / ((end - start) / 1e9), percentile(0.50), percentile(0.99), percentile(0.999), all.back() / 1000.0};
+}
+
+void printRow(const string& name, int threads, const BenchResult& r) {
+    cout << setw(8) << name << setw(8) << threads << setw(14) << (long long)r.opsPerSecond
+         << setw(10) << r.p50 << setw(10) << r.p99 << setw(10) << r.p999 << setw(12) << r.max << "\n";
+}
+
+// Usage: ./queue_bench [items] [capacity]
+int main(int argc, char* argv[]) {
+    int items = (argc > 1) ? stoi(argv[1]) : 1000000;
+    size_t capacity = (argc > 2) ? stoul(argv[2]) : 1024;
+    if (items < 1 || capacity < 1) {
+        cerr << "Usage: " << argv[0] << " [items] [capacity] (both must be positive)\n";
+        return 1;
+    }
+    cout << fixed << setprecision(1);
+    cout << "Each row: N producers and N consumers, " << items << " orders, capacity " << capacity << "\n";
+    cout << setw(8) << "queue" << setw(8) << "N" << setw(14) << "orders/s"
+         << setw(10) << "p50(us)" << setw(10) << "p99(us)" << setw(10) << "p99.9(us)" << setw(12) << "max(us)" << "\n";
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        printRow("mutex", threads, runBench<MutexQueue<OrderRecord>>(threads, items, capacity));
+        printRow("mpmc", threads, runBench<MPMCQueue<OrderRecord>>(threads, items, capacity));
+    }
+    return 0;
+}
@@ -9,6 +9,8 @@
 #include <thread>
 #include <cctype>
 #include <sstream>
+#include <functional>
+#include "bakery_sim.hpp"
 
 using namespace std;
 
@@ -19,17 +21,6 @@ const int MAX_BREAD_ORDER = 15;
 queue<pair<string, int>> Baker1Queue;
 vector<double> Times;
 
-void trim(string& str) {
-    size_t start = str.find_first_not_of(" ");
-    size_t end = str.find_last_not_of(" ");
-    if (start == string::npos || end == string::npos) {
-        str = "";
-    }
-    else {
-        str = str.substr(start, end - start + 1);
-    }
-}
-
 bool isValidNumber(const string& str) {
     for (char c : str) {
         if (!isdigit(c)) {
@@ -39,33 +30,27 @@ bool isValidNumber(const string& str) {
     return !str.empty();
 }
 
+// Splits a line on spaces in one pass, skipping empty words.
+vector<string> splitWords(const string& line) {
+    vector<string> words;
+    size_t start = line.find_first_not_of(' ');
+    while (start != string::npos) {
+        size_t end = line.find(' ', start);
+        words.push_back(line.substr(start, end - start));
+        start = line.find_first_not_of(' ', end);
+    }
+    return words;
+}
+
 void getOrder() {
     string line;
     vector<string> names;
     vector<int> counts;
     
     getline(cin, line);
-    trim(line);
-    size_t pos = 0;
-    while ((pos = line.find(' ')) != string::npos) {
-        string name = line.substr(0, pos);
-        trim(name);
-        if (!name.empty()) {
-            names.push_back(name);
-        }
-        line.erase(0, pos + 1);
-    }
-    trim(line);
-    if (!line.empty()) {
-        names.push_back(line);
-    }
+    names = splitWords(line);
     getline(cin, line);
-    trim(line);
-    
-    pos = 0;
-    while ((pos = line.find(' ')) != string::npos) {
-        string countStr = line.substr(0, pos);
-        trim(countStr);
+    for (const string& countStr : splitWords(line)) {
         if (isValidNumber(countStr)) {
             counts.push_back(stoi(countStr));
         }
@@ -73,17 +58,6 @@ void getOrder() {
             cerr << "Invalid number format in counts!\n";
             return;
         }
-        line.erase(0, pos + 1);
-    }
-    trim(line);
-    if (!line.empty()) {
-        if (isValidNumber(line)) {
-            counts.push_back(stoi(line));
-        }
-        else {
-            cerr << "Invalid number format in counts!\n";
-            return;
-        }
     }
 
     if (names.size() == counts.size()) {
@@ -124,6 +98,39 @@ void RunBakery() {
     }
 }
 
+// Same loop as RunBakery on a virtual clock: each batch is an event BREAD_BAKING_TIME_MS later.
+void SimulateBakery() {
+    EventLoop loop;
+    pair<string, int> order;
+    int remainingBreads = 0;
+    long long startTime = 0;
+    function<void()> fetchNextOrder;
+    function<void()> bakeNextBatch = [&]() {
+        if (remainingBreads <= 0) {
+            Times.push_back((loop.now() - startTime) / 1000000.0);
+            fetchNextOrder();
+            return;
+        }
+        int breadsToBake = min(remainingBreads, OVEN_CAPACITY);
+        loop.after(BREAD_BAKING_TIME_MS * 1000LL, [&, breadsToBake]() {
+            remainingBreads -= breadsToBake;
+            bakeNextBatch();
+        });
+    };
+    fetchNextOrder = [&]() {
+        if (Baker1Queue.empty()) {
+            return;
+        }
+        order = Baker1Queue.front();
+        Baker1Queue.pop();
+        startTime = loop.now();
+        remainingBreads = order.second;
+        bakeNextBatch();
+    };
+    loop.at(0, fetchNextOrder);
+    loop.run();
+}
+
 void calculateStats() {
     double sum = 0.0;
     for (double time : Times) {
@@ -142,9 +149,15 @@ void calculateStats() {
     cout << "Standard deviation: " << standardDeviation << " seconds\n";
 }
 
-int main() {
+// Usage: ./single [--simulate]
+int main(int argc, char* argv[]) {
     getOrder();
-    RunBakery();
+    if (argc > 1 && string(argv[1]) == "--simulate") {
+        SimulateBakery();
+    }
+    else {
+        RunBakery();
+    }
     cout << "All orders are complete.\n";
     calculateStats();
     return 0;
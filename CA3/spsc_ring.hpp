@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Bounded single-producer/single-consumer ring. Each side owns one index and keeps a cached copy
+// of the other's, so a push or pop normally touches no shared cache line but the slot itself.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t minCapacity) {
+        size_t capacity = 2;
+        while (capacity < minCapacity) capacity <<= 1;
+        mask = capacity - 1;
+        slots.reset(new T[capacity]);
+    }
+
+    // Producer only. Returns false if the ring is full.
+    bool tryPush(const T& value) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - cachedHead > mask) {
+            cachedHead = headIndex.load(std::memory_order_acquire);
+            if (tail - cachedHead > mask) return false;
+        }
+        slots[tail & mask] = value;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer only. True if the next `count` pushes are sure to succeed.
+    bool hasRoom(size_t count) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail + count - cachedHead > mask + 1) {
+            cachedHead = headIndex.load(std::memory_order_acquire);
+            if (tail + count - cachedHead > mask + 1) return false;
+        }
+        return true;
+    }
+
+    // Consumer only. Returns false if the ring is empty.
+    bool tryPop(T& value) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == cachedTail) {
+            cachedTail = tailIndex.load(std::memory_order_acquire);
+            if (head == cachedTail) return false;
+        }
+        value = slots[head & mask];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::unique_ptr<T[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> headIndex{0};
+    size_t cachedTail = 0;
+    alignas(64) std::atomic<size_t> tailIndex{0};
+    size_t cachedHead = 0;
+};
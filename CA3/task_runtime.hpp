@@ -0,0 +1,352 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "oven_manager.hpp"
+
+class TaskPool;
+
+// Fire-and-forget coroutine. It starts suspended; TaskPool::spawn schedules it and counts it as
+// live until its frame is destroyed when the body finishes.
+struct Task {
+    struct promise_type {
+        TaskPool* pool = nullptr;
+
+        Task get_return_object() { return Task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+        ~promise_type();
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Fixed pool of worker threads resuming ready coroutines from a shared run queue, plus one timer
+// thread that holds sleeping coroutines in a deadline heap. A suspended task costs only its
+// coroutine frame, so the number of tasks is not tied to the number of threads. The run queue is
+// unbounded on purpose: a worker that wakes another task must never block on a full queue while
+// the spawning thread keeps it full.
+class TaskPool {
+public:
+    explicit TaskPool(unsigned workers = std::thread::hardware_concurrency()) {
+        workers = std::max(1u, workers);
+        for (unsigned i = 0; i < workers; ++i) {
+            threads.emplace_back([this] { workerLoop(); });
+        }
+        timerThread = std::thread([this] { timerLoop(); });
+    }
+
+    ~TaskPool() {
+        waitIdle();
+        {
+            std::lock_guard<std::mutex> lock(timerMutex);
+            stopping = true;
+        }
+        timerCV.notify_all();
+        timerThread.join();
+        {
+            std::lock_guard<std::mutex> lock(runMutex);
+            closed = true;
+        }
+        runCV.notify_all();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void spawn(Task task) {
+        task.handle.promise().pool = this;
+        live.fetch_add(1);
+        schedule(task.handle);
+    }
+
+    // Makes a suspended coroutine runnable.
+    void schedule(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(runMutex);
+            runQueue.push_back(handle);
+        }
+        runCV.notify_one();
+    }
+
+    // Blocks the calling (non-worker) thread until every spawned task has finished.
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idleCV.wait(lock, [this] { return live.load() == 0; });
+    }
+
+    size_t workerCount() const { return threads.size(); }
+
+    struct SleepAwaiter {
+        TaskPool& pool;
+        long long micros;
+
+        bool await_ready() const { return micros <= 0; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            pool.addTimer(std::chrono::steady_clock::now() + std::chrono::microseconds(micros), handle);
+        }
+        void await_resume() {}
+    };
+
+    // co_await pool.sleepFor(us) suspends the task, not the worker thread.
+    SleepAwaiter sleepFor(long long micros) { return SleepAwaiter{ *this, micros }; }
+
+private:
+    friend struct Task::promise_type;
+
+    struct Timer {
+        std::chrono::steady_clock::time_point when;
+        long long sequence;
+        std::coroutine_handle<> handle;
+
+        bool operator>(const Timer& other) const {
+            return when != other.when ? when > other.when : sequence > other.sequence;
+        }
+    };
+
+    void taskFinished() {
+        if (live.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            idleCV.notify_all();
+        }
+    }
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(runMutex);
+        while (true) {
+            runCV.wait(lock, [this] { return !runQueue.empty() || closed; });
+            if (runQueue.empty()) return;
+            std::coroutine_handle<> handle = runQueue.front();
+            runQueue.pop_front();
+            lock.unlock();
+            handle.resume();
+            lock.lock();
+        }
+    }
+
+    void addTimer(std::chrono::steady_clock::time_point when, std::coroutine_handle<> handle) {
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> lock(timerMutex);
+            timers.push({ when, nextTimer++, handle });
+            earliest = timers.top().handle == handle;
+        }
+        if (earliest) timerCV.notify_one();
+    }
+
+    void timerLoop() {
+        std::unique_lock<std::mutex> lock(timerMutex);
+        while (!stopping) {
+            if (timers.empty()) {
+                timerCV.wait(lock);
+            } else if (timers.top().when <= std::chrono::steady_clock::now()) {
+                std::coroutine_handle<> handle = timers.top().handle;
+                timers.pop();
+                lock.unlock();
+                schedule(handle);
+                lock.lock();
+            } else {
+                timerCV.wait_until(lock, timers.top().when);
+            }
+        }
+    }
+
+    std::mutex runMutex;
+    std::condition_variable runCV;
+    std::deque<std::coroutine_handle<>> runQueue;
+    bool closed = false;
+    std::vector<std::thread> threads;
+    std::atomic<long long> live{0};
+    std::mutex idleMutex;
+    std::condition_variable idleCV;
+
+    std::thread timerThread;
+    std::mutex timerMutex;
+    std::condition_variable timerCV;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    long long nextTimer = 0;
+    bool stopping = false;
+};
+
+inline Task::promise_type::~promise_type() {
+    if (pool) pool->taskFinished();
+}
+
+// One-shot event with at most one waiting task. The state word is empty, the waiter's frame
+// address, or `this` once set, so neither side ever takes a lock.
+class AsyncEvent {
+public:
+    void set(TaskPool& pool) {
+        void* previous = state.exchange(this, std::memory_order_acq_rel);
+        if (previous != nullptr && previous != this) {
+            pool.schedule(std::coroutine_handle<>::from_address(previous));
+        }
+    }
+
+    struct Awaiter {
+        AsyncEvent& event;
+
+        bool await_ready() const { return event.state.load(std::memory_order_acquire) == &event; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            void* expected = nullptr;
+            return event.state.compare_exchange_strong(expected, handle.address(), std::memory_order_acq_rel,
+                                                       std::memory_order_acquire);
+        }
+        void await_resume() {}
+    };
+
+    Awaiter operator co_await() { return Awaiter{ *this }; }
+
+private:
+    std::atomic<void*> state{nullptr};
+};
+
+// Unbounded channel between tasks. pop() suspends the task while the queue is empty and yields
+// std::nullopt once the queue is closed and drained; push hands the value straight to a waiter.
+template <typename T>
+class AsyncQueue {
+public:
+    explicit AsyncQueue(TaskPool& pool) : pool(pool) {}
+
+    void push(const T& value) {
+        std::coroutine_handle<> wake;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (waiters.empty()) {
+                items.push_back(value);
+                return;
+            }
+            PopAwaiter* waiter = waiters.front();
+            waiters.pop_front();
+            waiter->value = value;
+            wake = waiter->handle;
+        }
+        pool.schedule(wake);
+    }
+
+    void close() {
+        std::deque<PopAwaiter*> closing;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            closed = true;
+            closing.swap(waiters);
+        }
+        for (PopAwaiter* waiter : closing) {
+            pool.schedule(waiter->handle);
+        }
+    }
+
+    struct PopAwaiter {
+        AsyncQueue& queue;
+        std::optional<T> value;
+        std::coroutine_handle<> handle;
+
+        bool await_ready() const { return false; }
+        bool await_suspend(std::coroutine_handle<> suspended) {
+            std::lock_guard<std::mutex> lock(queue.queueMutex);
+            if (!queue.items.empty()) {
+                value = queue.items.front();
+                queue.items.pop_front();
+                return false;
+            }
+            if (queue.closed) return false;
+            handle = suspended;
+            queue.waiters.push_back(this);
+            return true;
+        }
+        std::optional<T> await_resume() { return std::move(value); }
+    };
+
+    PopAwaiter pop() { return PopAwaiter{ *this, std::nullopt, {} }; }
+
+private:
+    TaskPool& pool;
+    std::mutex queueMutex;
+    std::deque<T> items;
+    std::deque<PopAwaiter*> waiters;
+    bool closed = false;
+};
+
+// The oven for tasks: the same OvenAllocator as OvenManager, but a request that cannot be granted
+// yet suspends the baking task, and whoever frees the space schedules it.
+class AsyncOven {
+public:
+    AsyncOven(TaskPool& pool, int capacity, OvenPolicy policy, bool packing)
+        : pool(pool), allocator(capacity, policy, packing) {}
+
+    struct AcquireAwaiter : OvenRequest {
+        AsyncOven& oven;
+        long long now;
+        std::coroutine_handle<> handle;
+
+        AcquireAwaiter(AsyncOven& oven, long long now) : oven(oven), now(now) {}
+
+        bool await_ready() const { return false; }
+        // Once the lock is released the task may already be resumed elsewhere and the awaiter
+        // destroyed, so everything needed afterwards is copied into locals first.
+        bool await_suspend(std::coroutine_handle<> suspended) {
+            handle = suspended;
+            AsyncOven& owner = oven;
+            TaskPool& pool = owner.pool;
+            std::vector<std::coroutine_handle<>> wake;
+            bool grantedNow;
+            {
+                std::lock_guard<std::mutex> lock(owner.ovenMutex);
+                owner.allocator.submit(this);
+                owner.allocator.grant(now, [&](OvenRequest* request) {
+                    if (request != this) wake.push_back(static_cast<AcquireAwaiter*>(request)->handle);
+                });
+                grantedNow = granted > 0;
+            }
+            for (std::coroutine_handle<> waiter : wake) {
+                pool.schedule(waiter);
+            }
+            return !grantedNow;
+        }
+        int await_resume() const { return granted; }
+    };
+
+    AcquireAwaiter acquire(int want, int jobSize, long long deadline, long long now) {
+        AcquireAwaiter awaiter(*this, now);
+        awaiter.want = std::min(want, allocator.getCapacity());
+        awaiter.jobSize = jobSize;
+        awaiter.deadline = deadline;
+        return awaiter;
+    }
+
+    void release(int breads, long long now) {
+        std::vector<std::coroutine_handle<>> wake;
+        {
+            std::lock_guard<std::mutex> lock(ovenMutex);
+            allocator.release(now, breads);
+            allocator.grant(now, [&](OvenRequest* request) {
+                wake.push_back(static_cast<AcquireAwaiter*>(request)->handle);
+            });
+        }
+        for (std::coroutine_handle<> waiter : wake) {
+            pool.schedule(waiter);
+        }
+    }
+
+    double utilization(long long start, long long now) {
+        std::lock_guard<std::mutex> lock(ovenMutex);
+        return allocator.utilization(start, now);
+    }
+
+private:
+    TaskPool& pool;
+    std::mutex ovenMutex;
+    OvenAllocator allocator;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Chase-Lev work-stealing deque of ints (order indices), using the C11 memory orderings from
+// Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models". The owner pushes and
+// pops at the bottom; other threads steal from the top. Capacity is fixed at construction.
+class WorkStealingDeque {
+public:
+    enum class StealResult { Success, Empty, Abort };
+
+    explicit WorkStealingDeque(size_t minCapacity) {
+        size_t capacity = 2;
+        while (capacity < minCapacity) capacity <<= 1;
+        mask = capacity - 1;
+        buffer.reset(new std::atomic<int>[capacity]);
+    }
+
+    // Owner only. Returns false if the deque is full.
+    bool push(int value) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t > (int64_t)mask) return false;
+        buffer[b & mask].store(value, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Owner only.
+    bool pop(int& value) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        value = buffer[b & mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread. Abort means another thief or the owner won the race; the deque may still have work.
+    StealResult steal(int& value) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return StealResult::Empty;
+        value = buffer[t & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return StealResult::Abort;
+        }
+        return StealResult::Success;
+    }
+
+    bool empty() const {
+        return top.load(std::memory_order_acquire) >= bottom.load(std::memory_order_acquire);
+    }
+
+private:
+    std::unique_ptr<std::atomic<int>[]> buffer;
+    size_t mask;
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+};
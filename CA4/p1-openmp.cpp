@@ -1,114 +1,1005 @@
-#include <chrono>
-#include <iostream>
-#include <omp.h>
-
-using namespace std::chrono;
-using namespace std;
-
-int m, n, k;
-int solutions = 0;
-
-void makeBoard(char** board) {
-#pragma omp parallel for collapse(2) schedule(static)
-    for (int i = 0; i < m; i++) {
-        for (int j = 0; j < n; j++) {
-            board[i][j] = '_';
-        }
-    }
-}
-
-void displayBoard(char** board) {
-    for (int i = 0; i < m; i++) {
-        for (int j = 0; j < n; j++) {
-            cout << " " << board[i][j] << " ";
-        }
-        cout << "\n";
-    }
-    cout << "\n";
-}
-
-void attack(int i, int j, char a, char** board) {
-    const int moves[8][2] = {
-        {2, -1}, {2, 1}, {-2, -1}, {-2, 1},
-        {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
-    };
-    for (int move = 0; move < 8; ++move) {
-        int ni = i + moves[move][0];
-        int nj = j + moves[move][1];
-        if (ni >= 0 && ni < m && nj >= 0 && nj < n) {
-            board[ni][nj] = a;
-        }
-    }
-}
-
-bool canPlace(int i, int j, char** board) {
-    return board[i][j] == '_';
-}
-
-void place(int i, int j, char k, char a, char** board, char** new_board) {
-#pragma omp parallel for collapse(2)
-    for (int y = 0; y < m; y++) {
-        for (int z = 0; z < n; z++) {
-            new_board[y][z] = board[y][z];
-        }
-    }
-    new_board[i][j] = k;
-    attack(i, j, a, new_board);
-}
-
-void kkn(int k, int sti, int stj, char** board) {
-    if (k == 0) {
-#pragma omp critical
-        {
-            displayBoard(board);
-            solutions++;
-        }
-    }
-    else {
-#pragma omp parallel for schedule(dynamic, 1) collapse(2)
-        for (int i = sti; i < m; i++) {
-            for (int j = (i == sti ? stj : 0); j < n; j++) {
-                if (canPlace(i, j, board)) {
-                    char** new_board = new char* [m];
-                    for (int x = 0; x < m; x++) {
-                        new_board[x] = new char[n];
-                    }
-                    place(i, j, 'K', 'A', board, new_board);
-                    kkn(k - 1, i, j, new_board);
-                    for (int x = 0; x < m; x++) {
-                        delete[] new_board[x];
-                    }
-                    delete[] new_board;
-                }
-            }
-        }
-    }
-}
-
-int main() {
-    m = 4, n = 4, k = 4;
-
-    char** board = new char* [m];
-    for (int i = 0; i < m; i++) {
-        board[i] = new char[n];
-    }
-
-    auto start = high_resolution_clock::now();
-
-    makeBoard(board);
-    kkn(k, 0, 0, board);
-
-    auto stop = high_resolution_clock::now();
-
-    auto duration = duration_cast<milliseconds>(stop - start);
-
-    cout << endl << "Total number of solutions : " << solutions;
-    cout << endl << "Time (milliseconds): " << duration.count() << endl;
-
-    for (int i = 0; i < m; i++) {
-        delete[] board[i];
-    }
-    delete[] board;
-
-    return 0;
-}
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <omp.h>
+#include <string>
+#include <vector>
+
+// Build with -DPRINT_BOARDS=0 to time the search alone; the board text is then never built.
+#ifndef PRINT_BOARDS
+#define PRINT_BOARDS 1
+#endif
+
+using namespace std::chrono;
+using namespace std;
+
+int m, n, k;
+string piece = "knight";
+vector<pair<string, int>> mix;
+int cutoff = 2;
+bool symmetric = false;
+bool uniqueOnly = false;
+bool countOnly = false;
+long long solutions = 0;
+long long uniqueSolutions = 0;
+
+// Boards are the program's output. Each thread appends its boards to its own buffer and writes
+// the buffer with one fwrite under a lock once it passes BOARD_FLUSH_BYTES, so there is no lock
+// per board and no board is lost. flushBoards writes what is left once the search is over.
+const size_t BOARD_FLUSH_BYTES = 1 << 16;
+mutex boardMutex;
+vector<unique_ptr<string>> boardBuffers;  // guarded by boardMutex
+
+void printBoard(const string& board) {
+    thread_local string* buffer = [] {
+        lock_guard<mutex> lock(boardMutex);
+        boardBuffers.push_back(make_unique<string>());
+        return boardBuffers.back().get();
+    }();
+    *buffer += board;
+    *buffer += '\n';
+    if (buffer->size() >= BOARD_FLUSH_BYTES) {
+        lock_guard<mutex> lock(boardMutex);
+        fwrite(buffer->data(), 1, buffer->size(), stdout);
+        buffer->clear();
+    }
+}
+
+// Only called once no thread is printing.
+void flushBoards() {
+    lock_guard<mutex> lock(boardMutex);
+    for (auto& buffer : boardBuffers) {
+        fwrite(buffer->data(), 1, buffer->size(), stdout);
+        buffer->clear();
+    }
+    fflush(stdout);
+}
+
+// Set of board squares, one bit per square in row-major order. WORDS is picked from the board
+// size, so a board of up to 64 squares is a single uint64_t.
+template <int WORDS>
+struct Bitboard {
+    uint64_t words[WORDS] = {};
+
+    void set(int square) { words[square >> 6] |= 1ULL << (square & 63); }
+    void clear(int square) { words[square >> 6] &= ~(1ULL << (square & 63)); }
+    bool test(int square) const { return words[square >> 6] >> (square & 63) & 1; }
+
+    bool empty() const {
+        for (int w = 0; w < WORDS; w++) {
+            if (words[w]) return false;
+        }
+        return true;
+    }
+
+    int count() const {
+        int total = 0;
+        for (int w = 0; w < WORDS; w++) {
+            total += popcount(words[w]);
+        }
+        return total;
+    }
+
+    // Index of the lowest set square; the set must not be empty.
+    int lowest() const {
+        for (int w = 0; w < WORDS - 1; w++) {
+            if (words[w]) return w * 64 + countr_zero(words[w]);
+        }
+        return (WORDS - 1) * 64 + countr_zero(words[WORDS - 1]);
+    }
+
+    Bitboard without(const Bitboard& other) const {
+        Bitboard result;
+        for (int w = 0; w < WORDS; w++) {
+            result.words[w] = words[w] & ~other.words[w];
+        }
+        return result;
+    }
+
+    Bitboard within(const Bitboard& other) const {
+        Bitboard result;
+        for (int w = 0; w < WORDS; w++) {
+            result.words[w] = words[w] & other.words[w];
+        }
+        return result;
+    }
+
+    // Lowest square in exactly one of the two sets, or -1 if they are equal.
+    int lowestDifference(const Bitboard& other) const {
+        for (int w = 0; w < WORDS; w++) {
+            uint64_t differ = words[w] ^ other.words[w];
+            if (differ) return w * 64 + countr_zero(differ);
+        }
+        return -1;
+    }
+
+    // Orders sets by their sorted square lists: the smaller set is the one holding the lowest
+    // square in which the two differ. Returns -1, 0 or 1.
+    int compare(const Bitboard& other) const {
+        int square = lowestDifference(other);
+        return square < 0 ? 0 : test(square) ? -1 : 1;
+    }
+};
+
+// Piece moves as constexpr data. A leaper attacks the squares one step away; a slider attacks
+// every square along each step direction up to the edge. Blockers are ignored on purpose: in an
+// independent placement no piece stands on the line between two others without being attacked.
+// `mark` is the symbol on single-piece boards (knights have always been shown as 'K'), `letter`
+// the one on mixed boards.
+struct Step {
+    int rows, cols;
+};
+
+struct Knight {
+    static constexpr const char* name = "knight";
+    static constexpr char mark = 'K', letter = 'N';
+    static constexpr bool slides = false;
+    static constexpr Step steps[] = { {2, -1}, {2, 1}, {-2, -1}, {-2, 1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2} };
+};
+
+struct King {
+    static constexpr const char* name = "king";
+    static constexpr char mark = 'K', letter = 'K';
+    static constexpr bool slides = false;
+    static constexpr Step steps[] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+};
+
+struct Bishop {
+    static constexpr const char* name = "bishop";
+    static constexpr char mark = 'B', letter = 'B';
+    static constexpr bool slides = true;
+    static constexpr Step steps[] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+};
+
+struct Rook {
+    static constexpr const char* name = "rook";
+    static constexpr char mark = 'R', letter = 'R';
+    static constexpr bool slides = true;
+    static constexpr Step steps[] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+};
+
+struct Queen {
+    static constexpr const char* name = "queen";
+    static constexpr char mark = 'Q', letter = 'Q';
+    static constexpr bool slides = true;
+    static constexpr Step steps[] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+};
+
+// Attack masks of Piece on every square of a rows x cols board. The step list and the sliding
+// flag are compile-time constants, so this unrolls into the piece's own loop.
+template <typename Piece, int WORDS>
+vector<Bitboard<WORDS>> attackTable(int rows, int cols) {
+    vector<Bitboard<WORDS>> attacks(rows * cols);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            for (const Step& step : Piece::steps) {
+                int ni = i + step.rows;
+                int nj = j + step.cols;
+                while (ni >= 0 && ni < rows && nj >= 0 && nj < cols) {
+                    attacks[i * cols + j].set(ni * cols + nj);
+                    if constexpr (!Piece::slides) break;
+                    ni += step.rows;
+                    nj += step.cols;
+                }
+            }
+        }
+    }
+    return attacks;
+}
+
+// A partial placement handed between tasks: the pieces placed so far and the squares still free
+// for the next one (above the last piece and not attacked).
+template <int WORDS>
+struct Node {
+    static constexpr int MAX_CUTOFF = 8;
+
+    Bitboard<WORDS> free;
+    int placed = 0;
+    int squares[MAX_CUTOFF];
+};
+
+// Per-thread totals. In symmetric mode `unique` counts canonical placements and `solutions` adds
+// up their orbit sizes; otherwise only `solutions` is used.
+struct alignas(64) ThreadCount {
+    long long solutions = 0;
+    long long unique = 0;
+};
+
+// Independent placement of one piece type on an m x n board. Every square's attack mask is
+// computed once from the piece's constexpr moves; a node of the search is then just the set of
+// squares still free after the last piece placed, and the search itself never looks at the piece.
+template <typename Piece, int WORDS>
+class PlacementSearch {
+public:
+    static constexpr int MAX_SQUARES = 64 * WORDS;
+    using Node = ::Node<WORDS>;
+
+    // One level of the sequential search below a node.
+    struct Frame {
+        Bitboard<WORDS> free;
+        int square;
+    };
+
+    PlacementSearch(int rows, int cols) : rows(rows), cols(cols), attacks(attackTable<Piece, WORDS>(rows, cols)) {
+        buildSymmetries();
+    }
+
+    int squares() const { return rows * cols; }
+
+    // The empty board: no pieces, every square free.
+    Node root() const {
+        Node node;
+        for (int square = 0; square < squares(); square++) {
+            node.free.set(square);
+        }
+        return node;
+    }
+
+    // Counts the ways to complete `node` to `pieces` pieces. Pieces are placed in increasing
+    // square order and a square is dropped from `free` once tried, so each placement is found
+    // exactly once. The recursion is an explicit stack of fixed depth: nothing is allocated per node.
+    // With SYMMETRIC only canonical placements are kept (see tallyCanonical); `node` must then
+    // already hold the first piece, whose placement restricts the rest of the search. Each frame
+    // then also carries its placement's images, and a frame with a smaller image is dropped with
+    // its whole subtree: pieces added later all lie above the first difference, so none of its
+    // completions can be the smallest of their orbit.
+    template <bool SYMMETRIC>
+    void countFrom(const Node& node, int pieces, ThreadCount& count) const {
+        if (node.placed == pieces) {
+            if constexpr (SYMMETRIC) {
+                Images images = imagesOf(node);
+                tallyCanonical(images, count);
+            } else {
+                if constexpr (PRINT_BOARDS) displayBoard(placement(node, nullptr, 0, -1));
+                count.solutions++;
+            }
+            return;
+        }
+        Frame stack[MAX_SQUARES + 1];
+        stack[0] = { node.free, -1 };
+        vector<Images> images(SYMMETRIC ? pieces - node.placed + 1 : 0);
+        if constexpr (SYMMETRIC) {
+            images[0] = imagesOf(node);
+            if (hasSmallerImage(images[0])) return;
+        }
+        int depth = 1;
+        while (depth > 0) {
+            Frame& top = stack[depth - 1];
+            int remaining = pieces - node.placed - (depth - 1);
+            if (top.free.count() < remaining) {
+                depth--;
+            } else if (remaining == 1) {
+                if constexpr (SYMMETRIC) {
+                    tallyLastPiece(images[depth - 1], top.free, count);
+                } else {
+                    // Every free square completes a placement.
+                    if constexpr (PRINT_BOARDS) {
+                        for (Bitboard<WORDS> last = top.free; !last.empty(); last.clear(last.lowest())) {
+                            displayBoard(placement(node, stack, depth, last.lowest()));
+                        }
+                    }
+                    count.solutions += top.free.count();
+                }
+                depth--;
+            } else {
+                // Taking the lowest free square also removes it from this frame, so the siblings
+                // tried after it only see the squares above it.
+                int square = top.free.lowest();
+                top.free.clear(square);
+                stack[depth] = { top.free.without(attacks[square]), square };
+                if constexpr (SYMMETRIC) {
+                    for (int g = 0; g < transforms; g++) {
+                        images[depth][g] = images[depth - 1][g];
+                        images[depth][g].set(image(g, square));
+                    }
+                    if (hasSmallerImage(images[depth])) continue;
+                }
+                depth++;
+            }
+        }
+    }
+
+    // Parallel search: nodes with fewer than `cutoff` pieces fan out into one OpenMP task per
+    // child, deeper ones are searched sequentially by countFrom. Each thread adds its results to
+    // its own counter, so the tasks share nothing but the read-only tables. In symmetric mode the
+    // first piece is always placed here, on a square that can lead a canonical placement.
+    template <bool SYMMETRIC>
+    void spawn(const Node& node, int pieces, int cutoff, ThreadCount* counts) const {
+        bool first = SYMMETRIC && node.placed == 0;
+        if ((node.placed >= cutoff && !first) || node.placed == pieces) {
+            countFrom<SYMMETRIC>(node, pieces, counts[omp_get_thread_num()]);
+            return;
+        }
+        Bitboard<WORDS> rest = node.free;
+        while (rest.count() >= pieces - node.placed) {
+            int square = rest.lowest();
+            rest.clear(square);
+            if (first && !leadsCanonical[square]) continue;
+            Node child = node;
+            child.squares[child.placed++] = square;
+            child.free = rest.without(attacks[square]);
+            if (first) child.free = child.free.within(canonicalAbove[square]);
+#pragma omp task firstprivate(child)
+            spawn<SYMMETRIC>(child, pieces, cutoff, counts);
+        }
+    }
+
+    void displayBoard(const Bitboard<WORDS>& pieceSet) const {
+        Bitboard<WORDS> attacked;
+        for (Bitboard<WORDS> rest = pieceSet; !rest.empty(); rest.clear(rest.lowest())) {
+            const Bitboard<WORDS>& targets = attacks[rest.lowest()];
+            for (int w = 0; w < WORDS; w++) {
+                attacked.words[w] |= targets.words[w];
+            }
+        }
+        string text;
+        text.reserve((size_t)rows * (3 * cols + 1));
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                int square = i * cols + j;
+                text += ' ';
+                text += pieceSet.test(square) ? Piece::mark : attacked.test(square) ? 'A' : '_';
+                text += ' ';
+            }
+            text += '\n';
+        }
+        printBoard(text);
+    }
+
+private:
+    // Images of one placement under every symmetry; [0] is the placement itself.
+    using Images = array<Bitboard<WORDS>, 8>;
+
+    // The board's symmetries as square permutations, identity first: the 4 reflections and
+    // half-turn of a rectangle, plus transposes and quarter-turns when the board is square.
+    // Every piece's attacks are preserved by all of them. A square may lead (be the lowest piece of) a
+    // canonical placement only if no symmetry maps it lower, and the other pieces of such a
+    // placement must lie on squares that no symmetry maps below it either.
+    void buildSymmetries() {
+        transforms = rows == cols ? 8 : 4;
+        symmetryTable.resize(transforms * squares());
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                int images[8][2] = {
+                    {i, j}, {rows - 1 - i, j}, {i, cols - 1 - j}, {rows - 1 - i, cols - 1 - j},
+                    {j, i}, {cols - 1 - j, rows - 1 - i}, {j, rows - 1 - i}, {cols - 1 - j, i}
+                };
+                for (int g = 0; g < transforms; g++) {
+                    symmetryTable[g * squares() + i * cols + j] = images[g][0] * cols + images[g][1];
+                }
+            }
+        }
+        canonicalAbove.assign(squares(), Bitboard<WORDS>());
+        leadsCanonical.assign(squares(), false);
+        for (int lead = 0; lead < squares(); lead++) {
+            leadsCanonical[lead] = lowestImage(lead) == lead;
+            for (int square = lead + 1; square < squares(); square++) {
+                if (lowestImage(square) >= lead) canonicalAbove[lead].set(square);
+            }
+        }
+    }
+
+    int image(int g, int square) const { return symmetryTable[g * squares() + square]; }
+
+    int lowestImage(int square) const {
+        int lowest = square;
+        for (int g = 0; g < transforms; g++) {
+            lowest = min(lowest, image(g, square));
+        }
+        return lowest;
+    }
+
+    Images imagesOf(const Node& node) const {
+        Images images;
+        for (int g = 0; g < transforms; g++) {
+            for (int i = 0; i < node.placed; i++) {
+                images[g].set(image(g, node.squares[i]));
+            }
+        }
+        return images;
+    }
+
+    bool hasSmallerImage(const Images& images) const {
+        for (int g = 1; g < transforms; g++) {
+            if (images[g].compare(images[0]) < 0) return true;
+        }
+        return false;
+    }
+
+    // Burnside-style weighting: a placement is kept only if it is the smallest of its images, and
+    // then stands for its whole orbit, whose size is the group order over its stabilizer's.
+    void tallyCanonical(const Images& images, ThreadCount& count) const {
+        int stabilizer = 1;
+        for (int g = 1; g < transforms; g++) {
+            int order = images[g].compare(images[0]);
+            if (order < 0) return;
+            if (order == 0) stabilizer++;
+        }
+        record(images, stabilizer, count);
+    }
+
+    // tallyCanonical for every completion of a placement by one piece on a square of `lasts`,
+    // without building each completion's images. The placement is not smaller than any of its
+    // images (its frame would have been dropped), so against image g it is either equal or first
+    // differs at a square `differ` that it holds. Adding piece x, whose image is y, keeps that
+    // unless y lands at or below `differ`; for an equal prefix only x against y matters.
+    void tallyLastPiece(const Images& images, Bitboard<WORDS> lasts, ThreadCount& count) const {
+        int differ[8];
+        for (int g = 1; g < transforms; g++) {
+            differ[g] = images[0].lowestDifference(images[g]);
+        }
+        for (; !lasts.empty(); lasts.clear(lasts.lowest())) {
+            int x = lasts.lowest();
+            int stabilizer = 1;
+            bool canonical = true;
+            for (int g = 1; g < transforms && canonical; g++) {
+                int y = image(g, x);
+                if (differ[g] < 0) {
+                    canonical = y >= x;
+                    stabilizer += y == x;
+                } else if (y == differ[g]) {
+                    Bitboard<WORDS> placed = images[0], imaged = images[g];
+                    placed.set(x);
+                    imaged.set(y);
+                    int order = imaged.compare(placed);
+                    canonical = order >= 0;
+                    stabilizer += order == 0;
+                } else {
+                    canonical = y > differ[g];
+                }
+            }
+            if (!canonical) continue;
+            Images completed = images;
+            if constexpr (PRINT_BOARDS) {
+                for (int g = 0; g < transforms; g++) {
+                    completed[g].set(image(g, x));
+                }
+            }
+            record(completed, stabilizer, count);
+        }
+    }
+
+    void record(const Images& images, int stabilizer, ThreadCount& count) const {
+        count.unique++;
+        count.solutions += transforms / stabilizer;
+        if constexpr (PRINT_BOARDS) {
+            if (uniqueOnly) {
+                displayBoard(images[0]);
+            } else {
+                displayOrbit(images);
+            }
+        }
+    }
+
+    // Prints every distinct image of a canonical placement, so the full listing matches the
+    // unreduced search.
+    void displayOrbit(const Images& images) const {
+        for (int g = 0; g < transforms; g++) {
+            bool repeated = false;
+            for (int other = 0; other < g; other++) {
+                repeated = repeated || images[other].compare(images[g]) == 0;
+            }
+            if (!repeated) displayBoard(images[g]);
+        }
+    }
+
+    Bitboard<WORDS> placement(const Node& node, const Frame* stack, int depth, int last) const {
+        Bitboard<WORDS> pieceSet;
+        for (int i = 0; i < node.placed; i++) {
+            pieceSet.set(node.squares[i]);
+        }
+        for (int level = 1; level < depth; level++) {
+            pieceSet.set(stack[level].square);
+        }
+        if (last >= 0) pieceSet.set(last);
+        return pieceSet;
+    }
+
+    int rows, cols;
+    vector<Bitboard<WORDS>> attacks;
+    int transforms;
+    vector<int> symmetryTable;
+    vector<Bitboard<WORDS>> canonicalAbove;
+    vector<bool> leadsCanonical;
+};
+
+// One parallel region for the whole search; a single thread seeds the task tree from the empty
+// board and the per-thread counts are summed after the region's barrier.
+template <typename Piece, int WORDS>
+ThreadCount placePieces(int rows, int cols, int pieces) {
+    PlacementSearch<Piece, WORDS> search(rows, cols);
+    vector<ThreadCount> counts(omp_get_max_threads());
+#pragma omp parallel
+#pragma omp single
+    {
+        if (symmetric) search.template spawn<true>(search.root(), pieces, cutoff, counts.data());
+        else search.template spawn<false>(search.root(), pieces, cutoff, counts.data());
+    }
+    ThreadCount total;
+    for (const ThreadCount& count : counts) {
+        total.solutions += count.solutions;
+        total.unique += count.unique;
+    }
+    return total;
+}
+
+template <typename Piece>
+ThreadCount placePieces(int rows, int cols, int pieces) {
+    if (pieces > rows * cols) return ThreadCount();
+    if (rows * cols <= 64) return placePieces<Piece, 1>(rows, cols, pieces);
+    if (rows * cols <= 128) return placePieces<Piece, 2>(rows, cols, pieces);
+    if (rows * cols <= 256) return placePieces<Piece, 4>(rows, cols, pieces);
+    return placePieces<Piece, 8>(rows, cols, pieces);
+}
+
+// Independent placement of several piece types together, e.g. 2 queens and 3 knights. The pieces
+// of one group are placed in increasing square order; the next group starts over from the lowest
+// square. Every attack relation here is symmetric, so the squares from which a new piece would
+// attack a placed one are read from the new piece's own table at the placed squares.
+template <int WORDS>
+class MixedSearch {
+public:
+    static constexpr int MAX_SQUARES = 64 * WORDS;
+
+    struct Group {
+        char letter;
+        int count;
+        vector<Bitboard<WORDS>> attacks;
+    };
+
+    MixedSearch(int rows, int cols, vector<Group> groups) : rows(rows), cols(cols), groups(move(groups)) {
+        for (int g = 0; g < (int)this->groups.size(); g++) {
+            levelGroup.insert(levelGroup.end(), this->groups[g].count, g);
+            groupEnd.push_back(levelGroup.size());
+        }
+        for (int square = 0; square < rows * cols; square++) {
+            board.set(square);
+        }
+    }
+
+    ThreadCount count() const {
+        ThreadCount total;
+        if (pieces() == 0) {
+            if constexpr (PRINT_BOARDS) displayBoard(nullptr, 0, -1);
+            total.solutions = 1;
+            return total;
+        }
+        long long solutions = 0;
+#pragma omp parallel for schedule(dynamic, 1) reduction(+ : solutions)
+        for (int first = 0; first < rows * cols; first++) {
+            solutions += countFrom(first);
+        }
+        total.solutions = solutions;
+        return total;
+    }
+
+private:
+    struct Frame {
+        Bitboard<WORDS> free;
+        Bitboard<WORDS> blocked;
+        int square;
+    };
+
+    int pieces() const { return levelGroup.size(); }
+
+    // Frame after piece number `level` goes on `square`: `free` are the candidates for the next
+    // piece and `blocked` the squares occupied or attacked so far. `rest` are the squares the
+    // piece's own group could still use; stack[0..level-1] hold the earlier pieces.
+    Frame place(const Frame* stack, int level, const Bitboard<WORDS>& rest, const Bitboard<WORDS>& blocked,
+                int square) const {
+        const Group& group = groups[levelGroup[level]];
+        Frame frame;
+        frame.square = square;
+        frame.blocked = blocked;
+        frame.blocked.set(square);
+        for (int w = 0; w < WORDS; w++) {
+            frame.blocked.words[w] |= group.attacks[square].words[w];
+        }
+        if (level + 1 < pieces() && levelGroup[level + 1] != levelGroup[level]) {
+            const Group& next = groups[levelGroup[level + 1]];
+            frame.free = board.without(frame.blocked).without(next.attacks[square]);
+            for (int i = 0; i < level; i++) {
+                frame.free = frame.free.without(next.attacks[stack[i].square]);
+            }
+        } else {
+            frame.free = rest.without(group.attacks[square]);
+        }
+        return frame;
+    }
+
+    // Same fixed-depth stack walk as PlacementSearch::countFrom, over all groups in turn.
+    long long countFrom(int first) const {
+        Frame stack[MAX_SQUARES + 1];
+        Bitboard<WORDS> above;
+        for (int square = first + 1; square < rows * cols; square++) {
+            above.set(square);
+        }
+        stack[0] = place(stack, 0, above, Bitboard<WORDS>(), first);
+        int depth = 1;
+        long long count = 0;
+        while (depth > 0) {
+            Frame& top = stack[depth - 1];
+            if (depth == pieces()) {
+                if constexpr (PRINT_BOARDS) displayBoard(stack, depth, -1);
+                count++;
+                depth--;
+            } else if (top.free.count() < groupEnd[levelGroup[depth]] - depth) {
+                depth--;
+            } else if (depth == pieces() - 1) {
+                if constexpr (PRINT_BOARDS) {
+                    for (Bitboard<WORDS> last = top.free; !last.empty(); last.clear(last.lowest())) {
+                        displayBoard(stack, depth, last.lowest());
+                    }
+                }
+                count += top.free.count();
+                depth--;
+            } else {
+                int square = top.free.lowest();
+                top.free.clear(square);
+                stack[depth] = place(stack, depth, top.free, top.blocked, square);
+                depth++;
+            }
+        }
+        return count;
+    }
+
+    // Pieces are shown by their letters; `last` (or -1) is one more piece after stack[0..depth-1].
+    void displayBoard(const Frame* stack, int depth, int last) const {
+        string cells(rows * cols, '_');
+        for (int level = 0; level < depth + (last >= 0); level++) {
+            int square = level < depth ? stack[level].square : last;
+            const Group& group = groups[levelGroup[level]];
+            for (Bitboard<WORDS> targets = group.attacks[square]; !targets.empty(); targets.clear(targets.lowest())) {
+                cells[targets.lowest()] = 'A';
+            }
+        }
+        for (int level = 0; level < depth + (last >= 0); level++) {
+            cells[level < depth ? stack[level].square : last] = groups[levelGroup[level]].letter;
+        }
+        string text;
+        text.reserve((size_t)rows * (3 * cols + 1));
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                text += ' ';
+                text += cells[i * cols + j];
+                text += ' ';
+            }
+            text += '\n';
+        }
+        printBoard(text);
+    }
+
+    int rows, cols;
+    vector<Group> groups;
+    vector<int> levelGroup;
+    vector<int> groupEnd;
+    Bitboard<WORDS> board;
+};
+
+// Attack table of the piece named `name`, or false if there is no such piece.
+template <int WORDS>
+bool attackTableOf(const string& name, int rows, int cols, char& letter, vector<Bitboard<WORDS>>& attacks) {
+    auto build = [&](auto piece) {
+        using Piece = decltype(piece);
+        letter = Piece::letter;
+        attacks = attackTable<Piece, WORDS>(rows, cols);
+    };
+    if (name == Knight::name) build(Knight());
+    else if (name == King::name) build(King());
+    else if (name == Bishop::name) build(Bishop());
+    else if (name == Rook::name) build(Rook());
+    else if (name == Queen::name) build(Queen());
+    else return false;
+    return true;
+}
+
+template <int WORDS>
+ThreadCount placeMixed(int rows, int cols, const vector<pair<string, int>>& mix) {
+    vector<typename MixedSearch<WORDS>::Group> groups;
+    for (const auto& [name, count] : mix) {
+        if (count == 0) continue;
+        typename MixedSearch<WORDS>::Group group;
+        group.count = count;
+        attackTableOf<WORDS>(name, rows, cols, group.letter, group.attacks);
+        groups.push_back(move(group));
+    }
+    return MixedSearch<WORDS>(rows, cols, move(groups)).count();
+}
+
+ThreadCount placeMixed(int rows, int cols, const vector<pair<string, int>>& mix) {
+    int pieces = 0;
+    for (const auto& group : mix) {
+        pieces += group.second;
+    }
+    if (pieces > rows * cols) return ThreadCount();
+    if (rows * cols <= 64) return placeMixed<1>(rows, cols, mix);
+    if (rows * cols <= 128) return placeMixed<2>(rows, cols, mix);
+    if (rows * cols <= 256) return placeMixed<4>(rows, cols, mix);
+    return placeMixed<8>(rows, cols, mix);
+}
+
+// Unsigned integer of LIMBS 64-bit words for the transfer-matrix counts. Only additions are
+// needed, and they wrap modulo 2^(64 * LIMBS), so LIMBS only has to fit the final answer.
+template <int LIMBS>
+struct BigCount {
+    uint64_t limbs[LIMBS] = {};
+
+    BigCount& operator+=(const BigCount& other) {
+        uint64_t carry = 0;
+        for (int i = 0; i < LIMBS; i++) {
+            uint64_t sum = limbs[i] + carry;
+            carry = sum < carry;
+            sum += other.limbs[i];
+            carry += sum < other.limbs[i];
+            limbs[i] = sum;
+        }
+        return *this;
+    }
+
+    bool zero() const {
+        for (int i = 0; i < LIMBS; i++) {
+            if (limbs[i]) return false;
+        }
+        return true;
+    }
+
+    string toString() const {
+        const uint64_t CHUNK = 1000000000000000000ULL;
+        BigCount value = *this;
+        string digits;
+        do {
+            unsigned __int128 remainder = 0;
+            for (int i = LIMBS - 1; i >= 0; i--) {
+                unsigned __int128 current = remainder << 64 | value.limbs[i];
+                value.limbs[i] = (uint64_t)(current / CHUNK);
+                remainder = current % CHUNK;
+            }
+            string chunk = to_string((uint64_t)remainder);
+            if (!value.zero()) chunk.insert(0, 18 - chunk.size(), '0');
+            digits.insert(0, chunk);
+        } while (!value.zero());
+        return digits;
+    }
+};
+
+// Counts placements row by row instead of enumerating them. A knight reaches at most two rows
+// ahead, so the rows already filled matter only through the masks of the last two; a state is
+// such a pair of masks with no knight of one attacking the other. Every state keeps one count per
+// number of knights placed so far (up to k). The board is laid with its narrower side as the row.
+template <int LIMBS>
+class KnightTransfer {
+public:
+    static constexpr int MAX_WIDTH = 10;
+
+    KnightTransfer(int rows, int cols) : length(max(rows, cols)), width(min(rows, cols)) {
+        int masks = 1 << width;
+        vector<int> index(masks * masks, -1);
+        for (int older = 0; older < masks; older++) {
+            for (int newer = 0; newer < masks; newer++) {
+                if (compatible(older, newer, 1)) {
+                    index[older * masks + newer] = states.size();
+                    states.push_back({ older, newer });
+                }
+            }
+        }
+        // The states that can precede (b, c) are the (a, b) with a two rows away from c.
+        predecessorStart.push_back(0);
+        for (const State& state : states) {
+            for (int older = 0; older < masks; older++) {
+                int before = index[older * masks + state.older];
+                if (before >= 0 && compatible(older, state.newer, 2)) predecessors.push_back(before);
+            }
+            predecessorStart.push_back(predecessors.size());
+        }
+        empty = index[0];
+    }
+
+    size_t stateCount() const { return states.size(); }
+
+    // Adds one row at a time; each new state pulls from its predecessors, so the states of a row
+    // are independent and split across threads with no synchronization.
+    BigCount<LIMBS> count(int knights) const {
+        int levels = knights + 1;
+        vector<BigCount<LIMBS>> current(states.size() * levels), next(states.size() * levels);
+        current[empty * levels].limbs[0] = 1;
+        for (int row = 0; row < length; row++) {
+#pragma omp parallel for schedule(dynamic, 64)
+            for (int target = 0; target < (int)states.size(); target++) {
+                BigCount<LIMBS>* out = &next[(size_t)target * levels];
+                fill(out, out + levels, BigCount<LIMBS>());
+                int added = popcount((unsigned)states[target].newer);
+                for (int i = predecessorStart[target]; i < predecessorStart[target + 1]; i++) {
+                    const BigCount<LIMBS>* in = &current[(size_t)predecessors[i] * levels];
+                    for (int placed = 0; placed + added < levels; placed++) {
+                        out[placed + added] += in[placed];
+                    }
+                }
+            }
+            current.swap(next);
+        }
+        BigCount<LIMBS> total;
+        for (size_t state = 0; state < states.size(); state++) {
+            total += current[state * levels + knights];
+        }
+        return total;
+    }
+
+private:
+    struct State {
+        int older, newer;
+    };
+
+    // No knight of one row attacks the other when they are `gap` rows apart (1 or 2): knights one
+    // row apart attack two columns over, two rows apart one column over.
+    bool compatible(int first, int second, int gap) const {
+        int shift = gap == 1 ? 2 : 1;
+        int reach = ((second << shift) | (second >> shift)) & ((1 << width) - 1);
+        return (first & reach) == 0;
+    }
+
+    int length, width;
+    vector<State> states;
+    vector<int> predecessorStart;
+    vector<int> predecessors;
+    int empty;
+};
+
+// The two count tables together may take at most this much memory.
+const size_t MAX_TABLE_BYTES = size_t(2) << 30;
+
+template <int LIMBS>
+bool countByRows(int rows, int cols, int knights, string& count, string& error) {
+    KnightTransfer<LIMBS> transfer(rows, cols);
+    double bytes = 2.0 * transfer.stateCount() * (knights + 1) * sizeof(BigCount<LIMBS>);
+    if (bytes > MAX_TABLE_BYTES) {
+        error = "the count tables would need " + to_string((long long)(bytes / (1 << 20))) + " MiB";
+        return false;
+    }
+    count = transfer.count(knights).toString();
+    return true;
+}
+
+// Picks the counter width from log2 C(squares, knights), an upper bound on the answer.
+bool countByRows(int rows, int cols, int knights, string& count, string& error) {
+    double squares = (double)rows * cols;
+    double bits = (lgamma(squares + 1) - lgamma(knights + 1.0) - lgamma(squares - knights + 1)) / log(2.0) + 8;
+    if (bits <= 64) return countByRows<1>(rows, cols, knights, count, error);
+    if (bits <= 128) return countByRows<2>(rows, cols, knights, count, error);
+    if (bits <= 256) return countByRows<4>(rows, cols, knights, count, error);
+    if (bits <= 512) return countByRows<8>(rows, cols, knights, count, error);
+    if (bits <= 1024) return countByRows<16>(rows, cols, knights, count, error);
+    if (bits <= 2048) return countByRows<32>(rows, cols, knights, count, error);
+    return countByRows<64>(rows, cols, knights, count, error);
+}
+
+// "queen:2,knight:3" -> {{"queen", 2}, {"knight", 3}}; every piece at most once.
+bool parseMix(const string& spec, vector<pair<string, int>>& groups) {
+    size_t start = 0;
+    while (start <= spec.size()) {
+        size_t end = spec.find(',', start);
+        if (end == string::npos) end = spec.size();
+        string item = spec.substr(start, end - start);
+        size_t colon = item.find(':');
+        if (colon == string::npos) return false;
+        string name = item.substr(0, colon);
+        int count = atoi(item.c_str() + colon + 1);
+        char letter;
+        vector<Bitboard<1>> unused;
+        if (count < 0 || !attackTableOf<1>(name, 0, 0, letter, unused)) return false;
+        for (const auto& group : groups) {
+            if (group.first == name) return false;
+        }
+        groups.push_back({ name, count });
+        start = end + 1;
+    }
+    return !groups.empty();
+}
+
+int main(int argc, char** argv) {
+    m = 4, n = 4, k = 4;
+    vector<char*> args;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--symmetric") == 0) {
+            symmetric = true;
+        } else if (strcmp(argv[i], "--unique") == 0) {
+            symmetric = uniqueOnly = true;
+        } else if (strcmp(argv[i], "--count") == 0) {
+            countOnly = true;
+        } else if (strcmp(argv[i], "--piece") == 0 && i + 1 < argc) {
+            piece = argv[++i];
+        } else if (strcmp(argv[i], "--mix") == 0 && i + 1 < argc) {
+            if (!parseMix(argv[++i], mix)) {
+                cerr << "--mix takes piece:count pairs such as queen:2,knight:3, each piece at most once" << endl;
+                return 1;
+            }
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    // With --mix the piece counts come from the mix, so the positional count is left out.
+    size_t countArgs = mix.empty() ? 3 : 2;
+    if (args.size() == countArgs || args.size() == countArgs + 1) {
+        m = atoi(args[0]), n = atoi(args[1]);
+        if (mix.empty()) k = atoi(args[2]);
+        if (args.size() > countArgs) cutoff = atoi(args[countArgs]);
+    } else if (!args.empty() || !mix.empty()) {
+        cerr << "usage: " << argv[0] << " [--symmetric | --unique | --count] [--piece knight|king|bishop|rook|queen]"
+             << " [rows cols pieces [task_cutoff]]" << endl
+             << "       " << argv[0] << " --mix piece:count,... rows cols" << endl;
+        return 1;
+    }
+    char letter;
+    vector<Bitboard<1>> unused;
+    if (!attackTableOf<1>(piece, 0, 0, letter, unused)) {
+        cerr << "unknown piece " << piece << endl;
+        return 1;
+    }
+    if (cutoff < 0 || cutoff > Node<1>::MAX_CUTOFF) {
+        cerr << "the task cutoff must be between 0 and " << Node<1>::MAX_CUTOFF << endl;
+        return 1;
+    }
+    if (!mix.empty() && (symmetric || countOnly)) {
+        cerr << "--mix cannot be combined with --symmetric, --unique or --count" << endl;
+        return 1;
+    }
+    if (countOnly) {
+        if (piece != Knight::name) {
+            cerr << "--count relies on knights reaching only two rows ahead; it counts knights only" << endl;
+            return 1;
+        }
+        if (m < 1 || n < 1 || k < 0 || min(m, n) > KnightTransfer<1>::MAX_WIDTH || (long long)m * n > 4096) {
+            cerr << "counting needs a board whose narrower side is at most " << KnightTransfer<1>::MAX_WIDTH
+                 << ", at most 4096 squares, and k must not be negative" << endl;
+            return 1;
+        }
+        auto start = high_resolution_clock::now();
+        string count = "0", error;
+        if (k <= m * n && !countByRows(m, n, k, count, error)) {
+            cerr << error << endl;
+            return 1;
+        }
+        auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+        cout << endl << "Total number of solutions : " << count;
+        cout << endl << "Time (milliseconds): " << duration.count() << endl;
+        return 0;
+    }
+    if (m < 1 || n < 1 || k < 0 || m * n > PlacementSearch<Knight, 8>::MAX_SQUARES) {
+        cerr << "the board must have between 1 and " << PlacementSearch<Knight, 8>::MAX_SQUARES
+             << " squares and k must not be negative" << endl;
+        return 1;
+    }
+
+    auto start = high_resolution_clock::now();
+
+    ThreadCount total;
+    if (!mix.empty()) total = placeMixed(m, n, mix);
+    else if (piece == Knight::name) total = placePieces<Knight>(m, n, k);
+    else if (piece == King::name) total = placePieces<King>(m, n, k);
+    else if (piece == Bishop::name) total = placePieces<Bishop>(m, n, k);
+    else if (piece == Rook::name) total = placePieces<Rook>(m, n, k);
+    else total = placePieces<Queen>(m, n, k);
+    solutions = total.solutions;
+    uniqueSolutions = total.unique;
+
+    auto stop = high_resolution_clock::now();
+
+    auto duration = duration_cast<milliseconds>(stop - start);
+
+    flushBoards();
+
+    cout << endl << "Total number of solutions : " << solutions;
+    if (symmetric) {
+        cout << endl << "Unique up to symmetry : " << uniqueSolutions;
+    }
+    cout << endl << "Time (milliseconds): " << duration.count() << endl;
+
+    return 0;
+}